@@ -194,6 +194,18 @@ ADSRControls::ADSRControls(const DataModel& dm)
     mDecayLabel.setText("Decay", juce::dontSendNotification);
     mSustainLabel.setText("Sustain", juce::dontSendNotification);
     mReleaseLabel.setText("Release", juce::dontSendNotification);
+    mCurveLabel.setText("Curve", juce::dontSendNotification);
+
+    // Item ids are EnvelopeCurve values + 1, since ComboBox reserves 0.
+    mCurveSelect.addItem("Linear", static_cast<int>(EnvelopeCurve::linear) + 1);
+    mCurveSelect.addItem("Exponential", static_cast<int>(EnvelopeCurve::exponential) + 1);
+    mCurveSelect.setSelectedId(static_cast<int>(EnvelopeCurve::linear) + 1, juce::dontSendNotification);
+    mCurveSelect.onChange = [this]
+    {
+        if (mActiveSample != nullptr)
+            mActiveSample->setEnvelopeCurve(static_cast<EnvelopeCurve>(mCurveSelect.getSelectedId() - 1));
+    };
+    addAndMakeVisible(mCurveSelect);
 }
 
 ADSRControls::~ADSRControls()
@@ -237,12 +249,20 @@ void ADSRControls::resized()
     releaseFlexBox.items.add(juce::FlexItem(mReleaseSlider).withFlex(5));
     releaseFlexBox.items.add(juce::FlexItem(mReleaseLabel).withFlex(1));
 
+    //Curve Component
+    juce::FlexBox curveFlexBox;
+    curveFlexBox.flexDirection = juce::FlexBox::Direction::column;
+    curveFlexBox.justifyContent = juce::FlexBox::JustifyContent::center;
+    curveFlexBox.items.add(juce::FlexItem(mCurveSelect).withHeight(24).withMargin(juce::FlexItem::Margin(0, spacing::padding3, 0, spacing::padding3)));
+    curveFlexBox.items.add(juce::FlexItem(mCurveLabel).withHeight(24));
+
     //Slider Layout
     juce::FlexBox sliderFlexBox;
     sliderFlexBox.items.add(juce::FlexItem(attackFlexBox).withFlex(1.0, 1.0));
     sliderFlexBox.items.add(juce::FlexItem(decayFlexBox).withFlex(1.0, 1.0));
     sliderFlexBox.items.add(juce::FlexItem(sustainFlexBox).withFlex(1.0, 1.0));
     sliderFlexBox.items.add(juce::FlexItem(releaseFlexBox).withFlex(1.0, 1.0));
+    sliderFlexBox.items.add(juce::FlexItem(curveFlexBox).withFlex(1.0, 1.0));
 
     sliderFlexBox.flexWrap = juce::FlexBox::Wrap::noWrap;
     sliderFlexBox.justifyContent = juce::FlexBox::JustifyContent::center;
@@ -258,7 +278,7 @@ std::vector<juce::Slider*> ADSRControls::getSliders()
 
 std::vector<juce::Label*> ADSRControls::getLabels()
 {
-    return { &mSampleLabel, &mAttackLabel, &mDecayLabel, &mSustainLabel, &mReleaseLabel };
+    return { &mSampleLabel, &mAttackLabel, &mDecayLabel, &mSustainLabel, &mReleaseLabel, &mCurveLabel };
 }
 
 void ADSRControls::sliderValueChanged(juce::Slider* slider)
@@ -300,11 +320,17 @@ void ADSRControls::activeSampleChanged(SampleModel& sm)
     mDecaySlider.setValue(params.decay);
     mSustainSlider.setValue(params.sustain);
     mReleaseSlider.setValue(params.release);
+    mCurveSelect.setSelectedId(static_cast<int>(mActiveSample->getEnvelopeCurve()) + 1, juce::dontSendNotification);
 
     //Set sample label 
     mSampleLabel.setText(mActiveSample->getName(), juce::dontSendNotification);
 }
 
+void ADSRControls::envelopeCurveChanged(EnvelopeCurve curve)
+{
+    mCurveSelect.setSelectedId(static_cast<int>(curve) + 1, juce::dontSendNotification);
+}
+
 
 //==============================================================================
 
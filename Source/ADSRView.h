@@ -61,11 +61,15 @@ private:
     // Data model listener
     void activeSampleChanged(SampleModel&) override;
 
+    // Sample model listener
+    void envelopeCurveChanged(EnvelopeCurve) override;
+
     // Slider listener 
     void sliderValueChanged(juce::Slider*) override;
 
     juce::Slider mAttackSlider, mDecaySlider, mSustainSlider, mReleaseSlider;
-    juce::Label mSampleLabel, mAttackLabel, mDecayLabel, mSustainLabel, mReleaseLabel;
+    juce::ComboBox mCurveSelect;
+    juce::Label mSampleLabel, mAttackLabel, mDecayLabel, mSustainLabel, mReleaseLabel, mCurveLabel;
 
     DataModel mDataModel;
     std::unique_ptr<SampleModel> mActiveSample;
@@ -21,21 +21,29 @@ PlaybackPositionOverlay::PlaybackPositionOverlay(const DataModel& dm, const Visi
 
 void PlaybackPositionOverlay::paint(juce::Graphics& g)
 {
-    if (mVisibleRange.getTotalRange().getLength() > 0)
+    if (mActiveSample == nullptr || mVisibleRange.getTotalRange().getLength() <= 0)
+        return;
+
+    const auto& snapshot = mProvidor();
+    const int padId = mActiveSample->getId();
+    const auto colour = getLookAndFeel().findColour(AppColors::ColourIds::ActionActive);
+
+    // A playhead per voice of the active pad, fading with its envelope.
+    for (int i = 0; i < snapshot.numVoices; ++i)
     {
-        g.setColour(getLookAndFeel().findColour(AppColors::ColourIds::ActionActive));
-        auto playbackInfo = mProvidor(); 
+        const auto& voice = snapshot.voices[(size_t)i];
+
+        if (voice.padId != padId)
+            continue;
 
-        if (mActiveSample->getMidiNote() == playbackInfo.midiNote)
-        {
-            auto xPos = timeToXPosition(playbackInfo.playbackPosition); 
+        auto xPos = static_cast<float>(timeToXPosition(voice.position));
 
-            juce::Path playhead; 
-            playhead.addTriangle(juce::Point<float>(xPos - 10, 0), juce::Point<float>(xPos + 10, 0), juce::Point<float>(xPos, 10));
+        juce::Path playhead; 
+        playhead.addTriangle(juce::Point<float>(xPos - 10, 0), juce::Point<float>(xPos + 10, 0), juce::Point<float>(xPos, 10));
 
-            g.fillPath(playhead);
-            g.drawVerticalLine(xPos, 0, static_cast<float>(getHeight()));
-        }
+        g.setColour(colour.withMultipliedAlpha(juce::jlimit(0.25f, 1.0f, voice.envelopeLevel)));
+        g.fillPath(playhead);
+        g.drawVerticalLine(juce::roundToInt(xPos), 0, static_cast<float>(getHeight()));
     }
 }
 
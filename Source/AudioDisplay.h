@@ -22,7 +22,8 @@ class PlaybackPositionOverlay : public juce::Component,
                                 private DataModel::Listener
 {
 public: 
-    using Providor = std::function<PlaybackData()>;
+    // Called on the message thread whenever the overlay repaints.
+    using Providor = std::function<const PlaybackSnapshot&()>;
     PlaybackPositionOverlay(const DataModel&, const VisibleRangeDataModel&, Providor);
 
     void paint(juce::Graphics&) override; 
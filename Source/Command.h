@@ -11,43 +11,145 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // We want to send type-erased commands to the audio thread, but we also
 // want those commands to contain move-only resources, so that we can
 // construct resources on the gui thread, and then transfer ownership
 // cheaply to the audio thread. We can't do this with std::function
-// because it enforces that functions are copy-constructible.
-// Therefore, we use a very simple templated type-eraser here.
-template <typename Proc>
-struct Command
-{
-    virtual ~Command() noexcept = default;
-    virtual void run(Proc& proc) = 0;
-};
-
-template <typename Proc, typename Func>
-class TemplateCommand : public Command<Proc>,
-    private Func
+// because it enforces that functions are copy-constructible, and it may
+// allocate. Therefore, we use a very simple small-buffer type-eraser here:
+// the command object lives inside a fixed-size slot and is driven through
+// a table of three function pointers.
+template <typename Proc, size_t Capacity>
+class InlineCommand
 {
 public:
-    template <typename FuncPrime>
-    explicit TemplateCommand(FuncPrime&& funcPrime)
-        : Func(std::forward<FuncPrime>(funcPrime))
+    InlineCommand() = default;
+    ~InlineCommand() { reset(); }
+
+    InlineCommand(InlineCommand&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    InlineCommand& operator= (InlineCommand&& other) noexcept
     {
+        if (this != &other)
+        {
+            reset();
+
+            if (other.ops != nullptr)
+            {
+                other.ops->relocate(other.storage, storage);
+                ops = std::exchange(other.ops, nullptr);
+            }
+        }
+
+        return *this;
     }
 
-    void run(Proc& proc) override { (*this) (proc); }
+    template <typename Func>
+    void emplace(Func&& func) noexcept
+    {
+        using Decayed = std::decay_t<Func>;
+
+        static_assert(sizeof(Decayed) <= Capacity, "Command is too large for the inline command storage");
+        static_assert(alignof(Decayed) <= alignof(std::max_align_t), "Command is over-aligned");
+        static_assert(std::is_nothrow_move_constructible<Decayed>::value, "Commands must be nothrow movable");
+
+        reset();
+        new (storage) Decayed(std::forward<Func>(func));
+        ops = &getOps<Decayed>();
+    }
+
+    void run(Proc& proc) const
+    {
+        jassert(ops != nullptr);
+        ops->run(const_cast<unsigned char*>(storage), proc);
+    }
+
+    void reset() noexcept
+    {
+        if (ops != nullptr)
+            std::exchange(ops, nullptr)->destroy(storage);
+    }
+
+    bool isEmpty() const noexcept { return ops == nullptr; }
+
+private:
+    struct Ops
+    {
+        void (*run)(void*, Proc&);
+        void (*relocate)(void* from, void* to) noexcept;
+        void (*destroy)(void*) noexcept;
+    };
+
+    template <typename Func>
+    static const Ops& getOps() noexcept
+    {
+        static const Ops ops
+        {
+            [](void* f, Proc& proc) { (*static_cast<Func*>(f))(proc); },
+            [](void* from, void* to) noexcept
+            {
+                new (to) Func(std::move(*static_cast<Func*>(from)));
+                static_cast<Func*>(from)->~Func();
+            },
+            [](void* f) noexcept { static_cast<Func*>(f)->~Func(); }
+        };
+
+        return ops;
+    }
+
+    alignas(std::max_align_t) unsigned char storage[Capacity];
+    const Ops* ops = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE(InlineCommand)
 };
 
+// Single-producer, single-consumer queue of InlineCommands held in
+// preallocated slots. Both ends are wait-free and need no lock: ordering
+// comes from the AbstractFifo indices alone. Debug builds assert that
+// only one thread ever produces. Neither side allocates or frees on the
+// hot path:
+// commands that have been run stay constructed in their slot until the
+// producer reuses the slot or calls collectGarbage().
+//
+// Commands pushed with a coalescing key (see makeKey) supersede earlier
+// pending commands with the same key, so only the most recent one is run.
+// If the queue is full, a keyed command is parked on the producer side and
+// retried later, in the order the commands were pushed, instead of being
+// lost; unkeyed commands are dropped. Either way the failure is counted.
 template <typename Proc>
 class CommandFifo final
 {
 public:
+    static constexpr size_t commandSize = 64;
+    static constexpr int noKey = -1;
+    static constexpr int maxCommandTypes = 8;
+    static constexpr int maxTargets = 128;
+    static constexpr int maxKeys = maxCommandTypes * maxTargets;
+
+    using Entry = InlineCommand<Proc, commandSize>;
+
+    static constexpr int makeKey(int commandType, int target) noexcept
+    {
+        return commandType * maxTargets + target;
+    }
+
     explicit CommandFifo(int size)
-        : buffer((size_t)size),
+        : slots((size_t)size),
         abstractFifo(size)
     {
+        lastIndexForKey.fill(-1);
     }
 
     CommandFifo()
@@ -55,34 +157,166 @@ public:
     {
     }
 
+    // Producer thread only. Returns false if the command could not be queued
+    // immediately.
     template <typename Item>
-    void push(Item&& item) noexcept
+    bool push(Item&& item, int key = noKey)
     {
-        auto command = makeCommand(std::forward<Item>(item));
+        jassert(key == noKey || (key >= 0 && key < maxKeys));
+        checkProducerThread();
 
-        abstractFifo.write(1).forEach([&](int index)
+        retryParked();
+
+        Entry command;
+        command.emplace(std::forward<Item>(item));
+
+        // A newer command must not overtake a parked one with the same key.
+        // It replaces it, and like a coalesced command in the queue, takes
+        // its place in the order from the newer push.
+        if (key != noKey)
+        {
+            auto parkedIt = parkedSequence.find(key);
+
+            if (parkedIt != parkedSequence.end())
             {
-                buffer[size_t(index)] = std::move(command);
-            });
+                parked.erase(parkedIt->second);
+                park(std::move(command), key);
+                numFailedPushes.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        if (tryWrite(command, key))
+            return true;
+
+        numFailedPushes.fetch_add(1, std::memory_order_relaxed);
+
+        if (key != noKey)
+            park(std::move(command), key);
+
+        return false;
     }
 
+    // Consumer thread only.
     void call(Proc& proc) noexcept
     {
-        abstractFifo.read(abstractFifo.getNumReady()).forEach([&](int index)
+        auto scope = abstractFifo.read(abstractFifo.getNumReady());
+
+        scope.forEach([&](int index)
             {
-                buffer[size_t(index)]->run(proc);
+                const auto& slot = slots[size_t(index)];
+
+                if (slot.key != noKey)
+                    lastIndexForKey[size_t(slot.key)] = index;
             });
+
+        scope.forEach([&](int index)
+            {
+                const auto& slot = slots[size_t(index)];
+
+                if (slot.key == noKey || lastIndexForKey[size_t(slot.key)] == index)
+                    slot.command.run(proc);
+            });
+    }
+
+    // Producer thread only. Destroys commands that have already been run and
+    // retries any parked commands.
+    void collectGarbage()
+    {
+        checkProducerThread();
+        retryParked();
+
+        int start1, size1, start2, size2;
+        abstractFifo.prepareToWrite(abstractFifo.getFreeSpace(), start1, size1, start2, size2);
+
+        for (int i = start1; i < start1 + size1; ++i)
+            slots[size_t(i)].command.reset();
+
+        for (int i = start2; i < start2 + size2; ++i)
+            slots[size_t(i)].command.reset();
     }
 
+    int getNumReady() const noexcept { return abstractFifo.getNumReady(); }
+    int getNumFailedPushes() const noexcept { return numFailedPushes.load(std::memory_order_relaxed); }
+
+    // Producer thread only.
+    int getNumParked() const noexcept { return static_cast<int>(parked.size()); }
+
 private:
-    template <typename Func>
-    static std::unique_ptr<Command<Proc>> makeCommand(Func&& func)
+    struct Slot
     {
-        using Decayed = std::decay_t<Func>;
-        return std::make_unique<TemplateCommand<Proc, Decayed>>(std::forward<Func>(func));
+        Entry command;
+        int key = noKey;
+    };
+
+    struct Parked
+    {
+        Entry command;
+        int key = noKey;
+    };
+
+    void checkProducerThread() noexcept
+    {
+       #if JUCE_DEBUG
+        const auto current = juce::Thread::getCurrentThreadId();
+        juce::Thread::ThreadID expected = nullptr;
+
+        if (!producerThread.compare_exchange_strong(expected, current))
+            jassert(expected == current); // Commands must all be pushed from the same thread
+       #endif
+    }
+
+    bool tryWrite(Entry& command, int key) noexcept
+    {
+        bool written = false;
+
+        abstractFifo.write(1).forEach([&](int index)
+            {
+                auto& slot = slots[size_t(index)];
+                slot.command = std::move(command);
+                slot.key = key;
+                written = true;
+            });
+
+        return written;
     }
 
-    std::vector<std::unique_ptr<Command<Proc>>> buffer;
+    void park(Entry&& command, int key)
+    {
+        const auto sequence = nextParkedSequence++;
+        auto& entry = parked[sequence];
+        entry.command = std::move(command);
+        entry.key = key;
+        parkedSequence[key] = sequence;
+    }
+
+    // Oldest first, so parked commands reach the consumer in push order.
+    void retryParked()
+    {
+        for (auto it = parked.begin(); it != parked.end();)
+        {
+            if (!tryWrite(it->second.command, it->second.key))
+                return;
+
+            parkedSequence.erase(it->second.key);
+            it = parked.erase(it);
+        }
+    }
+
+    std::vector<Slot> slots;
     juce::AbstractFifo abstractFifo;
-};
 
+    // Consumer thread only.
+    std::array<int, maxKeys> lastIndexForKey;
+
+    // Producer thread only. Parked commands by push sequence, and the
+    // sequence of the command parked for each key.
+    std::map<juce::uint64, Parked> parked;
+    std::map<int, juce::uint64> parkedSequence;
+    juce::uint64 nextParkedSequence = 0;
+    std::atomic<int> numFailedPushes { 0 };
+
+   #if JUCE_DEBUG
+    std::atomic<juce::Thread::ThreadID> producerThread { nullptr };
+   #endif
+};
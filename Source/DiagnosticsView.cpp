@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+    DiagnosticsView.cpp
+    Created: 18 Oct 2026 3:05:12am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "DiagnosticsView.h"
+
+namespace
+{
+    constexpr int refreshHz = 4;
+    constexpr int lineHeight = 18;
+    constexpr int maxOtherInstances = 3;
+
+    juce::String formatPercent(float load)
+    {
+        return juce::String(load * 100.0f, 1) + "%";
+    }
+}
+
+DiagnosticsView::DiagnosticsView(Providor providor)
+    :mProvidor(std::move(providor))
+{
+    mResetButton.setButtonText("Reset");
+    mResetButton.onClick = [this]
+    {
+        if (onReset != nullptr)
+            onReset();
+    };
+    addAndMakeVisible(mResetButton);
+
+    mThresholdLabel.setText("Overrun above", juce::dontSendNotification);
+    mThresholdLabel.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(mThresholdLabel);
+
+    mThresholdSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    mThresholdSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 50, 20);
+    mThresholdSlider.setRange(juce::Range<double>(0.1, 1.0), 0.05);
+    mThresholdSlider.setValue(PerformanceMonitor::defaultOverrunThreshold, juce::dontSendNotification);
+    mThresholdSlider.textFromValueFunction = [](double value) { return juce::String(juce::roundToInt(value * 100.0)) + "%"; };
+    mThresholdSlider.valueFromTextFunction = [](const juce::String& text) { return text.getDoubleValue() / 100.0; };
+    mThresholdSlider.updateText();
+    mThresholdSlider.onValueChange = [this]
+    {
+        if (onOverrunThresholdChanged != nullptr)
+            onOverrunThresholdChanged((float)mThresholdSlider.getValue());
+    };
+    addAndMakeVisible(mThresholdSlider);
+}
+
+DiagnosticsView::~DiagnosticsView()
+{
+    stopTimer();
+}
+
+void DiagnosticsView::visibilityChanged()
+{
+    // Tabs that are not selected are hidden, so this only polls while it can
+    // be seen.
+    if (isVisible())
+    {
+        timerCallback();
+        startTimerHz(refreshHz);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+void DiagnosticsView::timerCallback()
+{
+    if (mProvidor == nullptr)
+        return;
+
+    mReport = mProvidor();
+    mOtherInstances.clear();
+    mCombinedLoad = 0.0f;
+
+    for (const auto& other : PerformanceMonitor::getAllReports())
+    {
+        mCombinedLoad += other.lastLoad;
+
+        if (other.instanceId != mReport.instanceId)
+            mOtherInstances.push_back(other);
+    }
+
+    // Instances that each stay under their own threshold can still add up to
+    // a dropout, so they are ranked by load rather than by overruns.
+    std::sort(mOtherInstances.begin(), mOtherInstances.end(), [](const auto& a, const auto& b)
+        {
+            return a.maxLoad > b.maxLoad;
+        });
+
+    if (!mThresholdSlider.isMouseButtonDown())
+        mThresholdSlider.setValue(mReport.overrunThreshold, juce::dontSendNotification);
+
+    repaint();
+}
+
+void DiagnosticsView::paint(juce::Graphics& g)
+{
+    g.setColour(getLookAndFeel().findColour(AppColors::ColourIds::BackgroundDefault));
+    g.fillAll();
+
+    g.setColour(getLookAndFeel().findColour(AppColors::ColourIds::Divider));
+    auto bounds = getLocalBounds();
+    bounds.removeFromTop(spacing::padding3);
+    bounds.removeFromLeft(spacing::padding3);
+    bounds.removeFromRight(spacing::padding3);
+    g.fillRoundedRectangle(bounds.toFloat(), spacing::padding4);
+
+    auto content = bounds.reduced(spacing::padding3);
+    content.removeFromBottom(24 + spacing::padding4);
+
+    auto text = content.removeFromLeft(content.getWidth() / 2);
+    const auto& r = mReport;
+
+    const juce::String lastOverrun = r.lastOverrunTime == 0 ? juce::String("never")
+        : juce::Time(r.lastOverrunTime).toString(false, true, true, true);
+
+    juce::StringArray others;
+
+    for (size_t i = 0; i < mOtherInstances.size() && i < (size_t)maxOtherInstances; ++i)
+    {
+        const auto& other = mOtherInstances[i];
+        others.add("#" + juce::String(other.instanceId) + " " + formatPercent(other.maxLoad) + " peak, "
+                   + formatPercent(other.lastLoad) + " now, " + juce::String(other.numOverruns) + " over");
+    }
+
+    const juce::StringArray lines {
+        "Instance #" + juce::String(r.instanceId) + ", " + juce::String(r.numBlocks) + " blocks",
+        "Load: " + formatPercent(r.lastLoad) + " now, " + formatPercent(r.meanLoad) + " mean, " + formatPercent(r.maxLoad) + " peak",
+        "Overruns above " + formatPercent(r.overrunThreshold) + ": " + juce::String(r.numOverruns) + ", last " + lastOverrun,
+        "Voices: " + juce::String(r.maxActiveVoices) + " peak, " + juce::String(r.numSteals) + " stolen",
+        "Commands: " + juce::String(r.maxCommandQueueDepth) + " peak queued, " + juce::String(r.numFailedCommandPushes) + " dropped",
+        "Loader backlog: " + juce::String(r.loaderBacklog) + ", stream underruns: " + juce::String(r.numStreamUnderruns),
+        "All instances: " + formatPercent(mCombinedLoad) + " now",
+        "Busiest others: " + (others.isEmpty() ? juce::String("none") : others.joinIntoString("; "))
+    };
+
+    g.setColour(getLookAndFeel().findColour(AppColors::ColourIds::TextPrimary));
+    g.setFont(juce::Font(13.0f));
+
+    for (const auto& line : lines)
+        g.drawFittedText(line, text.removeFromTop(lineHeight), juce::Justification::centredLeft, 1);
+
+    drawLoadHistogram(g, content.withTrimmedLeft(spacing::padding3));
+}
+
+void DiagnosticsView::drawLoadHistogram(juce::Graphics& g, juce::Rectangle<int> area) const
+{
+    const auto& histogram = mReport.loadHistogram;
+    const auto maxCount = *std::max_element(histogram.begin(), histogram.end());
+
+    auto labels = area.removeFromBottom(lineHeight);
+    const float barWidth = area.getWidth() / (float)histogram.size();
+
+    g.setFont(juce::Font(11.0f));
+
+    for (size_t i = 0; i < histogram.size(); ++i)
+    {
+        const float x = area.getX() + barWidth * (float)i;
+        const float height = maxCount == 0 ? 0.0f : area.getHeight() * (float)histogram[i] / (float)maxCount;
+
+        // The last bucket holds the overruns.
+        const bool isOverrun = i == histogram.size() - 1;
+        g.setColour(getLookAndFeel().findColour(isOverrun ? AppColors::ColourIds::ActionActive : AppColors::ColourIds::Accent));
+        g.fillRect(juce::Rectangle<float>(x + 1.0f, area.getBottom() - height, barWidth - 2.0f, height));
+
+        g.setColour(getLookAndFeel().findColour(AppColors::ColourIds::TextSecondary));
+        g.drawText(isOverrun ? ">100" : juce::String((int)i * 10),
+            juce::Rectangle<float>(x, (float)labels.getY(), barWidth, (float)labels.getHeight()), juce::Justification::centred);
+    }
+}
+
+void DiagnosticsView::resized()
+{
+    auto bounds = getLocalBounds();
+    bounds.removeFromTop(spacing::padding3);
+    bounds = bounds.reduced(spacing::padding3 * 2, spacing::padding3);
+
+    auto row = bounds.removeFromBottom(24);
+    mResetButton.setBounds(row.removeFromLeft(80));
+    row.removeFromLeft(spacing::padding3);
+    mThresholdLabel.setBounds(row.removeFromLeft(100));
+    mThresholdSlider.setBounds(row.removeFromLeft(200));
+}
+
+void DiagnosticsView::lookAndFeelChanged()
+{
+    if (!dynamic_cast<juce::LookAndFeel_V4*>(&getLookAndFeel()))
+        mThresholdLabel.setColour(juce::Label::textColourId, getLookAndFeel().findColour(AppColors::ColourIds::TextPrimary));
+
+    repaint();
+}
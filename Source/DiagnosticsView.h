@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    DiagnosticsView.h
+    Created: 18 Oct 2026 3:05:12am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "PerformanceMonitor.h"
+#include "UIConfig.h"
+
+// Shows the processor's real-time statistics, refreshed a few times a second
+// while the view is showing.
+class DiagnosticsView : public juce::Component,
+    private juce::Timer
+{
+public:
+    using Providor = std::function<PerformanceMonitor::Report()>;
+
+    DiagnosticsView(Providor);
+    ~DiagnosticsView() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+    void visibilityChanged() override;
+    void lookAndFeelChanged() override;
+
+    // Called when the reset button is clicked.
+    std::function<void()> onReset;
+    // Called with the new threshold, as a share of the block, when the
+    // overrun threshold is changed.
+    std::function<void(float)> onOverrunThresholdChanged;
+
+private:
+    void timerCallback() override;
+    void drawLoadHistogram(juce::Graphics&, juce::Rectangle<int>) const;
+
+    Providor mProvidor;
+    PerformanceMonitor::Report mReport;
+    // Other instances in the process, busiest first, and the load of every
+    // instance's last block added up.
+    std::vector<PerformanceMonitor::Report> mOtherInstances;
+    float mCombinedLoad = 0.0f;
+
+    juce::TextButton mResetButton;
+    juce::Slider mThresholdSlider;
+    juce::Label mThresholdLabel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiagnosticsView)
+};
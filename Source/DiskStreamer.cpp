@@ -0,0 +1,274 @@
+/*
+  ==============================================================================
+
+    DiskStreamer.cpp
+    Created: 17 Oct 2026 4:41:09pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "DiskStreamer.h"
+#include <algorithm>
+
+//================================================================================
+StreamBuffer::StreamBuffer(int capacityFrames)
+    : capacity(capacityFrames)
+{
+}
+
+void StreamBuffer::start(StreamSource* source, juce::int64 firstFrame) noexcept
+{
+    pendingSource.store(source, std::memory_order_relaxed);
+    pendingStart.store(firstFrame, std::memory_order_relaxed);
+    requestGeneration.store(++localGeneration, std::memory_order_release);
+
+    lastWakeFrame = firstFrame;
+    wakeStreamer();
+}
+
+void StreamBuffer::wakeStreamer() noexcept
+{
+    if (streamer != nullptr)
+        streamer->workPending.store(true, std::memory_order_release);
+}
+
+void StreamBuffer::stop() noexcept
+{
+    if (pendingSource.load(std::memory_order_relaxed) != nullptr)
+        start(nullptr, 0);
+}
+
+bool StreamBuffer::isAcknowledged() const noexcept
+{
+    return acknowledgedGeneration.load(std::memory_order_acquire) == localGeneration;
+}
+
+bool StreamBuffer::read(juce::int64 startFrame, int numFrames, float* const* dest, int numChannels) noexcept
+{
+    int numValid = 0;
+
+    if (isAcknowledged())
+    {
+        const auto available = writeFrame.load(std::memory_order_acquire);
+        numValid = (int)juce::jlimit((juce::int64)0, (juce::int64)numFrames, available - startFrame);
+    }
+
+    // The ring is only touched once the streamer has acknowledged, and so
+    // allocated it for, the current request.
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        if (numValid > 0)
+        {
+            const int ringPos = (int)(startFrame % capacity);
+            const int firstPart = juce::jmin(numValid, capacity - ringPos);
+            const float* src = ring.getReadPointer(ch);
+
+            juce::FloatVectorOperations::copy(dest[ch], src + ringPos, firstPart);
+            juce::FloatVectorOperations::copy(dest[ch] + firstPart, src, numValid - firstPart);
+        }
+
+        juce::FloatVectorOperations::clear(dest[ch] + numValid, numFrames - numValid);
+    }
+
+    if (numValid < numFrames)
+    {
+        underruns.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+void StreamBuffer::release(juce::int64 frame) noexcept
+{
+    if (!isAcknowledged() || frame <= readFrame.load(std::memory_order_relaxed))
+        return;
+
+    readFrame.store(frame, std::memory_order_release);
+
+    // Matches the streamer's minimum read, so each wake has work to do.
+    if (frame - lastWakeFrame >= capacity / 4)
+    {
+        lastWakeFrame = frame;
+        wakeStreamer();
+    }
+}
+
+bool StreamBuffer::service(int minFramesPerRead)
+{
+    const auto generation = requestGeneration.load(std::memory_order_acquire);
+
+    if (generation != acknowledgedGeneration.load(std::memory_order_relaxed))
+    {
+        // If the audio thread posts again while we adopt this request, the
+        // acknowledgement below will not match its generation and the next
+        // pass adopts the newer request instead.
+        current = pendingSource.load(std::memory_order_relaxed);
+        const auto start = pendingStart.load(std::memory_order_relaxed);
+
+        // Published to the audio thread by the acknowledgement.
+        if (current == nullptr)
+            ring.setSize(0, 0);
+        else if (ring.getNumSamples() != capacity)
+            ring.setSize(2, capacity);
+
+        writeFrame.store(start, std::memory_order_relaxed);
+        readFrame.store(start, std::memory_order_relaxed);
+        acknowledgedGeneration.store(generation, std::memory_order_release);
+    }
+
+    if (current == nullptr)
+        return false;
+
+    const auto written = writeFrame.load(std::memory_order_relaxed);
+    const auto consumed = readFrame.load(std::memory_order_acquire);
+
+    const auto space = capacity - (written - consumed);
+    const auto remaining = current->getEndFrame() - written;
+    const int numToRead = (int)juce::jmin(space, remaining);
+
+    if (numToRead <= 0 || (numToRead < minFramesPerRead && numToRead < remaining))
+        return false;
+
+    const int ringPos = (int)(written % capacity);
+    const int firstPart = juce::jmin(numToRead, capacity - ringPos);
+    auto& reader = current->getReader();
+
+    reader.read(&ring, ringPos, firstPart, written, true, true);
+
+    if (numToRead > firstPart)
+        reader.read(&ring, 0, numToRead - firstPart, written + firstPart, true, true);
+
+    writeFrame.store(written + numToRead, std::memory_order_release);
+    return true;
+}
+
+void StreamBuffer::setCapacity(int capacityFrames)
+{
+    if (capacityFrames == capacity)
+        return;
+
+    capacity = capacityFrames;
+    ring.setSize(0, 0);
+
+    // Force the next request to be re-adopted from scratch.
+    current = nullptr;
+    acknowledgedGeneration.store(requestGeneration.load() - 1, std::memory_order_release);
+}
+
+//================================================================================
+DiskStreamer::DiskStreamer()
+    : juce::Thread("Sample streamer")
+{
+    startThread(juce::Thread::Priority::high);
+}
+
+DiskStreamer::~DiskStreamer()
+{
+    stopThread(2000);
+}
+
+void DiskStreamer::addStream(StreamBuffer& stream)
+{
+    const juce::ScopedLock sl(lock);
+    stream.setCapacity(readAheadFrames.load());
+    stream.streamer = this;
+    streams.push_back(&stream);
+}
+
+void DiskStreamer::removeStream(StreamBuffer& stream)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        streams.erase(std::remove(streams.begin(), streams.end(), &stream), streams.end());
+    }
+
+    // The streamer checks a stream is still registered before servicing it,
+    // so once any read in progress has finished it will not touch it again.
+    const juce::ScopedLock sl(serviceLock);
+}
+
+void DiskStreamer::registerSource(StreamSource::Ptr source)
+{
+    if (source == nullptr)
+        return;
+
+    const juce::ScopedLock sl(lock);
+
+    // Zones are registered again each time their pad is rebuilt.
+    if (std::find(sources.begin(), sources.end(), source) == sources.end())
+        sources.push_back(std::move(source));
+}
+
+void DiskStreamer::setReadAhead(int numFrames)
+{
+    const juce::ScopedLock serviceSl(serviceLock);
+    const juce::ScopedLock sl(lock);
+    readAheadFrames = juce::jmax(1024, numFrames);
+
+    for (auto* stream : streams)
+        stream->setCapacity(readAheadFrames.load());
+}
+
+int DiskStreamer::getNumUnderruns() const
+{
+    const juce::ScopedLock sl(lock);
+    int total = 0;
+
+    for (auto* stream : streams)
+        total += stream->getNumUnderruns();
+
+    return total;
+}
+
+void DiskStreamer::run()
+{
+    while (!threadShouldExit())
+    {
+        // Cleared before the streams are looked at, so a request posted
+        // during this pass is picked up by the next one.
+        workPending.store(false, std::memory_order_relaxed);
+
+        {
+            const juce::ScopedLock sl(lock);
+            toService = streams;
+
+            // Sources are only ever released here, once no sound and no
+            // stream refers to them.
+            sources.erase(std::remove_if(sources.begin(), sources.end(), [this](const StreamSource::Ptr& source)
+                {
+                    if (source->getReferenceCount() > 1)
+                        return false;
+
+                    return std::none_of(streams.begin(), streams.end(), [&](StreamBuffer* stream)
+                        {
+                            return stream->getCurrentSource() == source.get();
+                        });
+                }), sources.end());
+        }
+
+        bool didWork = false;
+        const int minFramesPerRead = readAheadFrames.load() / 4;
+
+        for (auto* stream : toService)
+        {
+            // Disk reads happen here, with only the service lock held.
+            const juce::ScopedLock serviceSl(serviceLock);
+
+            {
+                const juce::ScopedLock sl(lock);
+
+                if (std::find(streams.begin(), streams.end(), stream) == streams.end())
+                    continue;
+            }
+
+            didWork |= stream->service(minFramesPerRead);
+        }
+
+        // Streams raise workPending when they start, stop or drain; the
+        // message thread still notifies the thread directly.
+        if (!didWork && !workPending.load(std::memory_order_acquire))
+            wait(pollMilliseconds);
+    }
+}
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    DiskStreamer.h
+    Created: 17 Oct 2026 4:41:09pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+struct StreamingOptions
+{
+    bool enabled = true;
+    double thresholdSeconds = 10.0;   // Samples longer than this are streamed
+    double preloadSeconds = 1.0;      // Head of each streamed sample kept in RAM
+    int readAheadFrames = 32768;      // Size of each voice's ring buffer
+};
+
+//=====================================================================
+// The part of a streamed sample that is not held in memory. Only the
+// DiskStreamer thread reads from it, and only that thread ever drops the
+// last reference to one, so the audio thread can hand it around as a raw
+// pointer.
+class StreamSource : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<StreamSource>;
+
+    StreamSource(std::unique_ptr<juce::AudioFormatReader> sourceReader, juce::int64 numFramesToStream)
+        : reader(std::move(sourceReader)), endFrame(numFramesToStream)
+    {
+        jassert(reader != nullptr);
+    }
+
+    juce::AudioFormatReader& getReader() noexcept { return *reader; }
+    juce::int64 getEndFrame() const noexcept { return endFrame; }
+
+private:
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    juce::int64 endFrame;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamSource)
+};
+
+class DiskStreamer;
+
+//=====================================================================
+// Per-voice ring buffer fed by the DiskStreamer thread.
+//
+// The audio thread posts a request (source, first frame) and bumps a
+// generation counter. The streamer adopts the request and acknowledges the
+// generation, after which it appends frames and publishes writeFrame. The
+// audio thread only trusts the ring once the acknowledged generation
+// matches its latest request, and reports frames it no longer needs
+// through readFrame. No locks are taken on the audio thread: it wakes the
+// streamer by raising a flag the streamer polls, never through the
+// thread's own event.
+//
+// The ring is allocated by the streamer when it adopts a request for a
+// source, and freed when it adopts a stop, so only voices playing a
+// streamed sample hold one.
+class StreamBuffer
+{
+public:
+    explicit StreamBuffer(int capacityFrames);
+
+    //============ Audio thread ============
+    void start(StreamSource* source, juce::int64 firstFrame) noexcept;
+    void stop() noexcept;
+
+    // Copies frames [startFrame, startFrame + numFrames) into dest. Frames
+    // that have not been streamed yet are zero-filled and counted as an
+    // underrun. Returns false on underrun.
+    bool read(juce::int64 startFrame, int numFrames, float* const* dest, int numChannels) noexcept;
+
+    // Frames before this one may be overwritten by the streamer.
+    void release(juce::int64 frame) noexcept;
+
+    int getNumUnderruns() const noexcept { return underruns.load(std::memory_order_relaxed); }
+
+    //============ Streamer thread, with the DiskStreamer's service lock held ============
+    bool service(int minFramesPerRead);
+    StreamSource* getCurrentSource() const noexcept { return current; }
+
+    // Must not be called while the owning voice is rendering.
+    void setCapacity(int capacityFrames);
+
+private:
+    friend class DiskStreamer;
+
+    bool isAcknowledged() const noexcept;
+    void wakeStreamer() noexcept;
+
+    juce::AudioBuffer<float> ring;
+    int capacity;
+    DiskStreamer* streamer = nullptr;    // Set by DiskStreamer::addStream
+
+    // Audio thread only. The frame released when the streamer was last
+    // woken; it is woken again once it has room for a worthwhile read.
+    juce::int64 lastWakeFrame = 0;
+
+    // Request, written by the audio thread.
+    std::atomic<StreamSource*> pendingSource { nullptr };
+    std::atomic<juce::int64> pendingStart { 0 };
+    std::atomic<juce::uint32> requestGeneration { 0 };
+    juce::uint32 localGeneration = 0;
+
+    // Stream state, owned by the streamer thread.
+    StreamSource* current = nullptr;
+    std::atomic<juce::uint32> acknowledgedGeneration { 0 };
+    std::atomic<juce::int64> writeFrame { 0 };
+    std::atomic<juce::int64> readFrame { 0 };
+
+    std::atomic<int> underruns { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamBuffer)
+};
+
+//=====================================================================
+// Background I/O thread that keeps every registered StreamBuffer topped up.
+// It sleeps until a stream is started or stopped, or has drained far
+// enough to be worth refilling, and reads from disk without holding the
+// lock the message thread uses. Signalling a juce::Thread takes a lock, so
+// the audio thread only raises workPending, which the streamer checks
+// every pollMilliseconds while it is idle.
+class DiskStreamer : private juce::Thread
+{
+public:
+    DiskStreamer();
+    ~DiskStreamer() override;
+
+    //============ Message thread ============
+    void addStream(StreamBuffer&);
+    // Waits for the streamer if it is reading into this stream.
+    void removeStream(StreamBuffer&);
+
+    // Keeps the source alive until no sound or stream refers to it.
+    void registerSource(StreamSource::Ptr);
+    // Releases sources that no sound or stream refers to any more.
+    void releaseUnusedSources() { notify(); }
+
+    // Resizes every ring buffer. Must not be called while rendering.
+    void setReadAhead(int numFrames);
+    int getReadAhead() const noexcept { return readAheadFrames.load(); }
+
+    int getNumUnderruns() const;
+
+private:
+    friend class StreamBuffer;
+
+    void run() override;
+
+    // Well under the time a ring takes to drain by the quarter that makes a
+    // refill worthwhile, and under a streamed sound's preloaded head.
+    static constexpr int pollMilliseconds = 5;
+
+    juce::CriticalSection lock;
+    // Held by the streamer thread while it services a stream, and taken by
+    // anything that resizes or removes a stream. Always taken before lock.
+    juce::CriticalSection serviceLock;
+    std::vector<StreamBuffer*> streams;
+    std::vector<StreamBuffer*> toService;    // Streamer thread only
+    std::vector<StreamSource::Ptr> sources;
+    std::atomic<int> readAheadFrames { StreamingOptions().readAheadFrames };
+    // Raised by the audio thread.
+    std::atomic<bool> workPending { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiskStreamer)
+};
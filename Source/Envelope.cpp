@@ -0,0 +1,208 @@
+/*
+  ==============================================================================
+
+    Envelope.cpp
+    Created: 17 Oct 2026 10:14:37am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "Envelope.h"
+
+namespace
+{
+    // How far past the segment end the exponential curves aim. Smaller
+    // values give a more pronounced curve.
+    constexpr float attackCurvature = 0.3f;
+    constexpr float decayCurvature = 0.001f;
+}
+
+void BlockEnvelope::setSampleRate(double newSampleRate) noexcept
+{
+    jassert(newSampleRate > 0);
+    sampleRate = newSampleRate;
+}
+
+void BlockEnvelope::setParameters(const juce::ADSR::Parameters& newParams) noexcept
+{
+    params = newParams;
+
+    if (state == State::sustain)
+        enterState(State::sustain);
+}
+
+void BlockEnvelope::noteOn() noexcept
+{
+    enterState(State::attack);
+}
+
+void BlockEnvelope::noteOff() noexcept
+{
+    if (state != State::idle)
+        enterState(State::release);
+}
+
+void BlockEnvelope::reset() noexcept
+{
+    level = 0.0f;
+    state = State::idle;
+}
+
+BlockEnvelope::Segment BlockEnvelope::makeSegment(float from, float to, float seconds, float curvature) const noexcept
+{
+    const double numSamples = juce::jmax(1.0, seconds * sampleRate);
+    Segment s;
+    s.end = to;
+
+    if (curve == Curve::linear)
+    {
+        s.multiplier = 1.0f;
+        s.increment = static_cast<float>((to - from) / numSamples);
+        s.target = to;
+    }
+    else
+    {
+        // Aim past `to` so that the one-pole curve lands on it after exactly
+        // numSamples steps.
+        s.target = to + (to - from) * curvature;
+        s.multiplier = static_cast<float>(std::pow(curvature / (1.0 + curvature), 1.0 / numSamples));
+        s.increment = s.target * (1.0f - s.multiplier);
+    }
+
+    return s;
+}
+
+void BlockEnvelope::enterState(State newState) noexcept
+{
+    state = newState;
+
+    switch (state)
+    {
+    case State::attack:
+        if (params.attack <= 0.0f)
+        {
+            level = 1.0f;
+            enterState(State::decay);
+            return;
+        }
+
+        segment = makeSegment(level, 1.0f, params.attack, attackCurvature);
+        break;
+
+    case State::decay:
+        if (params.decay <= 0.0f || level <= params.sustain)
+        {
+            enterState(State::sustain);
+            return;
+        }
+
+        segment = makeSegment(level, params.sustain, params.decay, decayCurvature);
+        break;
+
+    case State::sustain:
+        level = params.sustain;
+
+        // A silent sustain would hold the voice open without producing output.
+        if (level < silenceThreshold)
+            reset();
+        break;
+
+    case State::release:
+        if (params.release <= 0.0f || level < silenceThreshold)
+        {
+            reset();
+            return;
+        }
+
+        segment = makeSegment(level, 0.0f, params.release, decayCurvature);
+        segment.end = silenceThreshold;
+        break;
+
+    case State::idle:
+        level = 0.0f;
+        break;
+    }
+}
+
+int BlockEnvelope::samplesUntilSegmentEnd() const noexcept
+{
+    double steps = 0.0;
+
+    if (segment.multiplier == 1.0f)
+    {
+        if (segment.increment == 0.0f)
+            return 0;
+
+        steps = (segment.end - level) / segment.increment;
+    }
+    else
+    {
+        const double ratio = (segment.end - segment.target) / (double)(level - segment.target);
+
+        if (ratio <= 0.0 || ratio >= 1.0)
+            return 0;
+
+        steps = std::log(ratio) / std::log((double)segment.multiplier);
+    }
+
+    // Tolerate rounding in the log so a segment is not stretched by a sample.
+    return steps > 0.0 ? (int)std::ceil(steps - 1.0e-3) : 0;
+}
+
+int BlockEnvelope::render(float* dest, int numSamples) noexcept
+{
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        if (state == State::idle)
+        {
+            juce::FloatVectorOperations::clear(dest + done, numSamples - done);
+            return done;
+        }
+
+        if (state == State::sustain)
+        {
+            juce::FloatVectorOperations::fill(dest + done, level, numSamples - done);
+            return numSamples;
+        }
+
+        const int remaining = samplesUntilSegmentEnd();
+        const int numThisSegment = juce::jmin(remaining, numSamples - done);
+
+        const float multiplier = segment.multiplier;
+        const float increment = segment.increment;
+        float value = level;
+        float* out = dest + done;
+
+        for (int i = 0; i < numThisSegment; ++i)
+        {
+            value = value * multiplier + increment;
+            out[i] = value;
+        }
+
+        level = value;
+        done += numThisSegment;
+
+        if (numThisSegment == remaining)
+        {
+            // Land exactly on the segment end and move on to the next stage.
+            if (state == State::release)
+            {
+                reset();
+            }
+            else
+            {
+                level = segment.end;
+
+                if (numThisSegment > 0)
+                    out[numThisSegment - 1] = level;
+
+                enterState(state == State::attack ? State::decay : State::sustain);
+            }
+        }
+    }
+
+    return numSamples;
+}
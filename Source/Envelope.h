@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    Envelope.h
+    Created: 17 Oct 2026 10:14:37am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//=====================================================================
+// ADSR envelope that renders whole segments into a gain buffer instead of
+// being ticked once per sample. Every ramp is expressed as
+// level = level * multiplier + increment, so linear and exponential curves
+// share the same branch-free inner loop, and the length of each segment is
+// solved up front so the loop never tests for the segment end.
+class BlockEnvelope
+{
+public:
+    enum class Curve
+    {
+        linear,
+        exponential
+    };
+
+    // Below this level (-80 dB) a releasing envelope is considered finished.
+    static constexpr float silenceThreshold = 1.0e-4f;
+
+    BlockEnvelope() = default;
+
+    void setSampleRate(double newSampleRate) noexcept;
+    void setParameters(const juce::ADSR::Parameters&) noexcept;
+    void setCurve(Curve newCurve) noexcept { curve = newCurve; }
+
+    void noteOn() noexcept;
+    void noteOff() noexcept;
+    void reset() noexcept;
+
+    bool isActive() const noexcept { return state != State::idle; }
+    float getCurrentLevel() const noexcept { return level; }
+
+    // Writes numSamples gain values to dest and returns how many of them were
+    // rendered before the envelope became idle. The remainder is zero-filled.
+    int render(float* dest, int numSamples) noexcept;
+
+private:
+    enum class State
+    {
+        idle,
+        attack,
+        decay,
+        sustain,
+        release
+    };
+
+    struct Segment
+    {
+        float multiplier = 1.0f;
+        float increment = 0.0f;
+        float target = 0.0f;
+        float end = 0.0f;
+    };
+
+    void enterState(State) noexcept;
+    Segment makeSegment(float from, float to, float seconds, float curvature) const noexcept;
+    int samplesUntilSegmentEnd() const noexcept;
+
+    State state = State::idle;
+    Segment segment;
+    float level = 0.0f;
+    double sampleRate = 44100.0;
+    juce::ADSR::Parameters params;
+    Curve curve = Curve::linear;
+
+    JUCE_LEAK_DETECTOR(BlockEnvelope)
+};
@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+    FilterView.cpp
+    Created: 18 Oct 2026 5:37:51am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "FilterView.h"
+
+FilterView::FilterView(const DataModel& dm)
+    :mDataModel(dm)
+{
+    mDataModel.addListener(*this);
+
+    auto initSlider = [this](juce::Slider& slider, juce::Label& label, const juce::String& text)
+    {
+        label.setText(text, juce::dontSendNotification);
+        label.setJustificationType(juce::Justification::centred);
+        addAndMakeVisible(label);
+
+        slider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
+        slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 15);
+        slider.addListener(this);
+        addAndMakeVisible(slider);
+    };
+
+    // Ranges match the pads' filter parameters.
+    initSlider(mCutoffSlider, mCutoffLabel, "Cutoff");
+    mCutoffSlider.setRange(juce::Range<double>(20, 20000), 0.1);
+    mCutoffSlider.setSkewFactorFromMidPoint(1000);
+    mCutoffSlider.setTextValueSuffix(" Hz");
+
+    initSlider(mResonanceSlider, mResonanceLabel, "Resonance");
+    mResonanceSlider.setRange(juce::Range<double>(0.1, 20), 0.001);
+    mResonanceSlider.setSkewFactorFromMidPoint(1);
+
+    initSlider(mEnvelopeSlider, mEnvelopeLabel, "Envelope");
+    mEnvelopeSlider.setRange(juce::Range<double>(-8, 8), 0.01);
+    mEnvelopeSlider.setTextValueSuffix(" oct");
+
+    initSlider(mVelocitySlider, mVelocityLabel, "Velocity");
+    mVelocitySlider.setRange(juce::Range<double>(-8, 8), 0.01);
+    mVelocitySlider.setTextValueSuffix(" oct");
+
+    mModeLabel.setText("Filter", juce::dontSendNotification);
+    mModeLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(mModeLabel);
+
+    // Item ids are FilterMode values + 1, since ComboBox reserves 0.
+    mModeSelect.addItem("Off", static_cast<int>(FilterMode::off) + 1);
+    mModeSelect.addItem("Lowpass", static_cast<int>(FilterMode::lowpass) + 1);
+    mModeSelect.addItem("Bandpass", static_cast<int>(FilterMode::bandpass) + 1);
+    mModeSelect.addItem("Highpass", static_cast<int>(FilterMode::highpass) + 1);
+    mModeSelect.onChange = [this] { updateFilter(); };
+    addAndMakeVisible(mModeSelect);
+
+    updateControls({});
+}
+
+FilterView::~FilterView()
+{
+    mDataModel.removeListener(*this);
+
+    if (mActiveSample != nullptr)
+        mActiveSample->removeListener(*this);
+}
+
+void FilterView::paint(juce::Graphics& g)
+{
+    g.setColour(getLookAndFeel().findColour(AppColors::ColourIds::BackgroundDefault));
+    g.fillAll();
+
+    g.setColour(getLookAndFeel().findColour(AppColors::ColourIds::Divider));
+    auto bounds = getLocalBounds();
+    bounds.removeFromTop(spacing::padding3);
+    bounds.removeFromLeft(spacing::padding3);
+    bounds.removeFromRight(spacing::padding3);
+    g.fillRoundedRectangle(bounds.toFloat(), spacing::padding4);
+}
+
+void FilterView::resized()
+{
+    juce::Grid grid;
+
+    using Track = juce::Grid::TrackInfo;
+    using Fr = juce::Grid::Fr;
+
+    grid.templateRows = { Track(Fr(3)), Track(Fr(1)), Track(Fr(3)), Track(Fr(1)) };
+    grid.templateColumns = { Track(Fr(1)), Track(Fr(1)), Track(Fr(1)), Track(Fr(1)) };
+    grid.items = { juce::GridItem(mModeSelect).withArea(1,1).withHeight(24).withAlignSelf(juce::GridItem::AlignSelf::center)
+                                              .withMargin(juce::GridItem::Margin(0, spacing::padding3, 0, spacing::padding3)),
+                   juce::GridItem(mModeLabel).withArea(2,1),
+                   juce::GridItem(mCutoffSlider).withArea(1,2),
+                   juce::GridItem(mCutoffLabel).withArea(2,2),
+                   juce::GridItem(mResonanceSlider).withArea(1,3),
+                   juce::GridItem(mResonanceLabel).withArea(2,3),
+                   juce::GridItem(mEnvelopeSlider).withArea(3,2),
+                   juce::GridItem(mEnvelopeLabel).withArea(4,2),
+                   juce::GridItem(mVelocitySlider).withArea(3,3),
+                   juce::GridItem(mVelocityLabel).withArea(4,3)
+    };
+
+    grid.performLayout(getLocalBounds().reduced(spacing::padding3));
+}
+
+void FilterView::activeSampleChanged(SampleModel& sm)
+{
+    if (mActiveSample != nullptr)
+        mActiveSample->removeListener(*this);
+
+    mActiveSample = std::make_unique<SampleModel>(sm.getState());
+    mActiveSample->addListener(*this);
+
+    updateControls(mActiveSample->getFilter());
+}
+
+void FilterView::filterChanged(FilterParameters filter)
+{
+    updateControls(filter);
+}
+
+void FilterView::sliderValueChanged(juce::Slider*)
+{
+    updateFilter();
+}
+
+void FilterView::updateFilter()
+{
+    if (mActiveSample == nullptr)
+        return;
+
+    FilterParameters filter;
+    filter.mode = static_cast<FilterMode>(mModeSelect.getSelectedId() - 1);
+    filter.cutoff = (float)mCutoffSlider.getValue();
+    filter.resonance = (float)mResonanceSlider.getValue();
+    filter.envelopeAmount = (float)mEnvelopeSlider.getValue();
+    filter.velocityAmount = (float)mVelocitySlider.getValue();
+    mActiveSample->setFilter(filter);
+}
+
+void FilterView::updateControls(const FilterParameters& filter)
+{
+    mModeSelect.setSelectedId(static_cast<int>(filter.mode) + 1, juce::dontSendNotification);
+    mCutoffSlider.setValue(filter.cutoff, juce::dontSendNotification);
+    mResonanceSlider.setValue(filter.resonance, juce::dontSendNotification);
+    mEnvelopeSlider.setValue(filter.envelopeAmount, juce::dontSendNotification);
+    mVelocitySlider.setValue(filter.velocityAmount, juce::dontSendNotification);
+}
+
+void FilterView::lookAndFeelChanged()
+{
+    if (!dynamic_cast<juce::LookAndFeel_V4*>(&getLookAndFeel()))
+    {
+        for (auto* label : { &mModeLabel, &mCutoffLabel, &mResonanceLabel, &mEnvelopeLabel, &mVelocityLabel })
+            label->setColour(juce::Label::textColourId, getLookAndFeel().findColour(AppColors::ColourIds::TextPrimary));
+    }
+}
@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    FilterView.h
+    Created: 18 Oct 2026 5:37:51am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "Model.h"
+#include "UIConfig.h"
+
+class FilterView : public juce::Component,
+    public juce::Slider::Listener,
+    private DataModel::Listener,
+    private SampleModel::Listener
+{
+public:
+    FilterView(const DataModel&);
+    ~FilterView() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+    void lookAndFeelChanged() override;
+
+private:
+    // Sample model listener
+    void filterChanged(FilterParameters) override;
+
+    // Data model listener
+    void activeSampleChanged(SampleModel&) override;
+
+    // Slider listener
+    void sliderValueChanged(juce::Slider*) override;
+
+    void updateFilter();
+    void updateControls(const FilterParameters&);
+
+    juce::ComboBox mModeSelect;
+    juce::Label mModeLabel;
+    juce::Slider mCutoffSlider, mResonanceSlider, mEnvelopeSlider, mVelocitySlider;
+    juce::Label mCutoffLabel, mResonanceLabel, mEnvelopeLabel, mVelocityLabel;
+
+    DataModel mDataModel;
+    std::unique_ptr<SampleModel> mActiveSample;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FilterView)
+};
@@ -11,19 +11,31 @@
 #include "MainSamplerView.h"
 
 
-MainSamplerView::MainSamplerView(const DataModel& dataModel, PlaybackPositionOverlay::Providor providor)
+MainSamplerView::MainSamplerView(const DataModel& dataModel, PlaybackPositionOverlay::Providor providor,
+    DiagnosticsView::Providor diagnosticsProvidor, std::function<void()> onResetDiagnostics,
+    std::function<void(float)> onOverrunThresholdChanged)
     :mDataModel(dataModel), 
     mSampleButtons(dataModel.getState()), 
     mAudioEditor(dataModel, std::move(providor)), 
     mADSRView(dataModel), 
     mPitchView(dataModel), 
+    mRegionView(dataModel),
+    mFilterView(dataModel),
+    mSettingsView(dataModel),
+    mDiagnosticsView(std::move(diagnosticsProvidor)),
     mTabView(juce::TabbedButtonBar::Orientation::TabsAtTop)
 {
     mDataModel.addListener(*this);
+    mDiagnosticsView.onReset = std::move(onResetDiagnostics);
+    mDiagnosticsView.onOverrunThresholdChanged = std::move(onOverrunThresholdChanged);
 
     mTabView.addTab("Editor", juce::Colours::darkgrey, &mAudioEditor, false);
     mTabView.addTab("ADSR", juce::Colours::darkgrey, &mADSRView, false);
     mTabView.addTab("Pitch", juce::Colours::darkgrey, &mPitchView, false);
+    mTabView.addTab("Region", juce::Colours::darkgrey, &mRegionView, false);
+    mTabView.addTab("Filter", juce::Colours::darkgrey, &mFilterView, false);
+    mTabView.addTab("Settings", juce::Colours::darkgrey, &mSettingsView, false);
+    mTabView.addTab("Diagnostics", juce::Colours::darkgrey, &mDiagnosticsView, false);
     mTabView.setCurrentTabIndex(0); 
 
     addAndMakeVisible(mSampleButtons); 
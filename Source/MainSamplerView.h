@@ -18,12 +18,18 @@
 #include "UIConfig.h"
 #include "AudioDisplay.h"
 #include "PitchView.h"
+#include "RegionView.h"
+#include "FilterView.h"
+#include "DiagnosticsView.h"
+#include "SettingsView.h"
 
 class MainSamplerView : public juce::Component, 
                         private DataModel::Listener
 {
 public:
-    MainSamplerView(const DataModel& dataModel, PlaybackPositionOverlay::Providor); 
+    MainSamplerView(const DataModel& dataModel, PlaybackPositionOverlay::Providor,
+        DiagnosticsView::Providor, std::function<void()> onResetDiagnostics,
+        std::function<void(float)> onOverrunThresholdChanged); 
     ~MainSamplerView() override; 
 
     void paint(juce::Graphics&) override;
@@ -39,4 +45,8 @@ private:
     AudioEditor mAudioEditor; 
     ADSRView mADSRView; 
     PitchView mPitchView; 
+    RegionView mRegionView;
+    FilterView mFilterView;
+    SettingsView mSettingsView;
+    DiagnosticsView mDiagnosticsView;
 };
\ No newline at end of file
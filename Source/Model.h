@@ -24,14 +24,25 @@ namespace IDs
     DECLARE_ID(id)
     DECLARE_ID(name)
     DECLARE_ID(file)
+    DECLARE_ID(zones)
     DECLARE_ID(isActive)
     DECLARE_ID(midiNote)
     DECLARE_ID(adsr)
+    DECLARE_ID(envelopeCurve)
     DECLARE_ID(pitchShift)
+    DECLARE_ID(gain)
+    DECLARE_ID(interpolation)
+    DECLARE_ID(region)
+    DECLARE_ID(filter)
+    DECLARE_ID(loadState)
+    DECLARE_ID(loadError)
     DECLARE_ID(totalRange)
     DECLARE_ID(hZoom)
     DECLARE_ID(hScroll)
 
+    DECLARE_ID(renderThreads)
+    DECLARE_ID(embedSamples)
+
     DECLARE_ID(VISIBLE_RANGE)
     DECLARE_ID(visibleRange)
 
@@ -138,6 +149,128 @@ struct juce::VariantConverter<ADSRParameters>
 {
 };
 
+// The part of a pad's sample that plays, in seconds from the start of the
+// file. An end of 0 plays to the end of the sample. While looping, the
+// voice plays from start to loopEnd and then repeats loopStart..loopEnd
+// until it is released, blending the last `crossfade` seconds of the loop
+// into the audio leading up to loopStart. The crossfade can be no longer
+// than the audio before loopStart, so a loop from the very start of the
+// sample wraps without one.
+struct SampleRegion
+{
+    double start = 0.0, end = 0.0;
+    double loopStart = 0.0, loopEnd = 0.0;
+    double crossfade = 0.0;
+    bool isLooping = false;
+
+    bool operator==(const SampleRegion& other) const
+    {
+        return start == other.start && end == other.end
+            && loopStart == other.loopStart && loopEnd == other.loopEnd
+            && crossfade == other.crossfade && isLooping == other.isLooping;
+    }
+
+    bool operator!=(const SampleRegion& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+template<>
+struct juce::VariantConverter<SampleRegion>
+    : GenericVariantConverter<SampleRegion>
+{
+};
+
+// One of the files a pad plays, and the velocities it answers. Files with
+// the same velocity range form a layer and take turns, round-robin.
+struct ZoneFile
+{
+    juce::File file;
+    int lowVelocity = 1, highVelocity = 127;
+
+    bool operator==(const ZoneFile& other) const
+    {
+        return file == other.file && lowVelocity == other.lowVelocity && highVelocity == other.highVelocity;
+    }
+
+    bool operator!=(const ZoneFile& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+template<>
+struct juce::VariantConverter<std::vector<ZoneFile>>
+    : GenericVariantConverter<std::vector<ZoneFile>>
+{
+};
+
+enum class FilterMode
+{
+    off = 0,
+    lowpass,
+    bandpass,
+    highpass
+};
+
+// A pad's per-voice filter. Each voice's cutoff is raised (or lowered) by
+// envelopeAmount octaves at full envelope level and by velocityAmount
+// octaves at full velocity.
+struct FilterParameters
+{
+    FilterMode mode = FilterMode::off;
+    float cutoff = 20000.0f;          // Hz
+    float resonance = 0.7071f;        // Q
+    float envelopeAmount = 0.0f;      // Octaves
+    float velocityAmount = 0.0f;      // Octaves
+
+    bool operator==(const FilterParameters& other) const
+    {
+        return mode == other.mode && cutoff == other.cutoff && resonance == other.resonance
+            && envelopeAmount == other.envelopeAmount && velocityAmount == other.velocityAmount;
+    }
+
+    bool operator!=(const FilterParameters& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+template<>
+struct juce::VariantConverter<FilterParameters>
+    : GenericVariantConverter<FilterParameters>
+{
+};
+
+// Resampling quality used when a pad is played back away from its root
+// pitch. Values are stored in the SAMPLE tree as ints.
+enum class InterpolationMode
+{
+    linear = 0,
+    hermite,
+    sinc
+};
+
+constexpr int numInterpolationModes = 3;
+
+// Shape of a pad's envelope segments. Values are stored in the SAMPLE tree
+// as ints.
+enum class EnvelopeCurve
+{
+    linear = 0,
+    exponential
+};
+
+// Progress of the background decode for a pad's audio file.
+enum class LoadState
+{
+    empty = 0,
+    loading,
+    ready,
+    failed
+};
+
 
 class Model : public juce::ValueTree::Listener
 {
@@ -249,9 +382,20 @@ public:
         virtual void isActiveChanged(bool) {}
         virtual void midiNoteChanged(int) {}
         virtual void adsrChanged(ADSRParameters) {}
+        virtual void envelopeCurveChanged(EnvelopeCurve) {}
         virtual void pitchShiftChanged(int) {}
+        virtual void gainChanged(float) {}
+        virtual void interpolationModeChanged(InterpolationMode) {}
+        virtual void regionChanged(SampleRegion) {}
+        virtual void totalRangeChanged(juce::Range<double>) {}
+        virtual void filterChanged(FilterParameters) {}
+        virtual void loadStateChanged(LoadState) {}
     };
 
+    // The pad gain's range, in decibels; the minimum is silence.
+    static constexpr float minGainDecibels = -60.0f;
+    static constexpr float maxGainDecibels = 12.0f;
+
      explicit SampleModel()
         :SampleModel(juce::ValueTree(IDs::SAMPLE)) {}
 
@@ -260,11 +404,19 @@ public:
         id(getState(), IDs::id, nullptr), 
         name(getState(), IDs::name, nullptr),
         audioFile(getState(), IDs::file, nullptr), 
+        zoneFiles(getState(), IDs::zones, nullptr),
         midiNote(getState(), IDs::midiNote, nullptr),
         adsr(getState(), IDs::adsr, nullptr),
+        envelopeCurve(getState(), IDs::envelopeCurve, nullptr),
         isActiveSample(getState(), IDs::isActive, nullptr),
         totalRange(getState(), IDs::totalRange, nullptr), 
         pitchShift(getState(), IDs::pitchShift, nullptr),
+        gain(getState(), IDs::gain, nullptr),
+        interpolation(getState(), IDs::interpolation, nullptr),
+        region(getState(), IDs::region, nullptr),
+        filter(getState(), IDs::filter, nullptr),
+        loadState(getState(), IDs::loadState, nullptr),
+        loadError(getState(), IDs::loadError, nullptr),
         hZoom(getState(), IDs::hZoom, nullptr),
         hScroll(getState(), IDs::hScroll, nullptr)
     {
@@ -283,12 +435,60 @@ public:
 
     void setAudioFile(const juce::File& file)
     {
-        audioFile.setValue(std::make_shared<juce::File>(file), nullptr); 
-        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file)); 
+        setAudioFiles({ file }, false);
+    }
+
+    // Plays every file on the pad. By default they take turns, round-robin;
+    // asVelocityLayers instead splits the velocity range between them in
+    // order, the first file taking the softest notes. The first file is the
+    // one shown.
+    void setAudioFiles(const juce::Array<juce::File>& files, bool asVelocityLayers)
+    {
+        jassert(!files.isEmpty());
+
+        std::vector<ZoneFile> zones;
+        const int numFiles = files.size();
+
+        for (int i = 0; i < numFiles; ++i)
+        {
+            ZoneFile zone { files[i] };
+
+            if (asVelocityLayers)
+            {
+                zone.lowVelocity = juce::jmin(127, 1 + 127 * i / numFiles);
+                zone.highVelocity = juce::jmax(zone.lowVelocity, 127 * (i + 1) / numFiles);
+            }
+
+            zones.push_back(zone);
+        }
+
+        // The zones are set first: a change of file is what starts the load.
+        zoneFiles.setValue(zones, nullptr);
+        audioFile.setValue(std::make_shared<juce::File>(files.getFirst()), nullptr); 
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(files.getFirst())); 
         
         setTotalRange(juce::Range<double>(0, static_cast<double>(reader->lengthInSamples / reader->sampleRate)));
     }
 
+    // Sets the zones without opening their files, for a pad restored from
+    // saved state whose length is already known.
+    void restoreAudioFiles(const std::vector<ZoneFile>& zones, const juce::Range<double> range)
+    {
+        jassert(!zones.empty());
+
+        setTotalRange(range);
+        zoneFiles.setValue(zones, nullptr);
+        audioFile.setValue(std::make_shared<juce::File>(zones.front().file), nullptr);
+    }
+
+    // Empties the pad, for a restored state in which it had no sample.
+    void clearAudioFile()
+    {
+        zoneFiles.resetToDefault(nullptr);
+        audioFile.resetToDefault(nullptr);
+        setTotalRange(juce::Range<double>(0, 0));
+    }
+
     void setIsActive(const bool active) 
     {
         isActiveSample.setValue(active, nullptr);
@@ -305,6 +505,11 @@ public:
         midiNote.setValue(clipped, nullptr); 
     }
 
+    void setADSR(const ADSRParameters& params)
+    {
+        adsr.setValue(params, nullptr);
+    }
+
     void setAttack(const float a)
     {
         ADSRParameters params = getADSR(); 
@@ -344,6 +549,49 @@ public:
         pitchShift.setValue(constrainedSemitones, nullptr); 
     }
 
+    // In decibels.
+    void setGain(float decibels)
+    {
+        gain.setValue(juce::jlimit(minGainDecibels, maxGainDecibels, decibels), nullptr);
+    }
+
+    void setEnvelopeCurve(EnvelopeCurve curve)
+    {
+        envelopeCurve.setValue(static_cast<int>(curve), nullptr);
+    }
+
+    void setInterpolationMode(InterpolationMode mode)
+    {
+        interpolation.setValue(static_cast<int>(mode), nullptr); 
+    }
+
+    void setRegion(const SampleRegion& newRegion)
+    {
+        SampleRegion clipped = newRegion;
+        clipped.start = juce::jmax(0.0, clipped.start);
+        clipped.end = juce::jmax(0.0, clipped.end);
+        clipped.loopStart = juce::jmax(0.0, clipped.loopStart);
+        clipped.loopEnd = juce::jmax(clipped.loopStart, clipped.loopEnd);
+        clipped.crossfade = juce::jmax(0.0, clipped.crossfade);
+        region.setValue(clipped, nullptr);
+    }
+
+    void setFilter(const FilterParameters& newFilter)
+    {
+        FilterParameters clipped = newFilter;
+        clipped.cutoff = juce::jlimit(20.0f, 20000.0f, clipped.cutoff);
+        clipped.resonance = juce::jlimit(0.1f, 20.0f, clipped.resonance);
+        clipped.envelopeAmount = juce::jlimit(-8.0f, 8.0f, clipped.envelopeAmount);
+        clipped.velocityAmount = juce::jlimit(-8.0f, 8.0f, clipped.velocityAmount);
+        filter.setValue(clipped, nullptr);
+    }
+
+    void setLoadState(LoadState state, const juce::String& error = {})
+    {
+        loadError.setValue(error, nullptr); 
+        loadState.setValue(static_cast<int>(state), nullptr); 
+    }
+
     void setHZoom(double zoom)
     {
         hZoom.setValue(zoom, nullptr); 
@@ -365,6 +613,12 @@ public:
         return audioFile; 
     }
 
+    // Empty for a pad that has never had a file.
+    std::vector<ZoneFile> getZoneFiles() const
+    {
+        return zoneFiles;
+    }
+
     bool isActive() const 
     {
         return isActiveSample; 
@@ -403,6 +657,41 @@ public:
         return pitchShift; 
     }
 
+    float getGain() const
+    {
+        return gain;
+    }
+
+    EnvelopeCurve getEnvelopeCurve() const
+    {
+        return static_cast<EnvelopeCurve>(juce::jlimit(0, 1, static_cast<int>(envelopeCurve)));
+    }
+
+    InterpolationMode getInterpolationMode() const
+    {
+        return static_cast<InterpolationMode>(juce::jlimit(0, 2, static_cast<int>(interpolation))); 
+    }
+
+    SampleRegion getRegion() const
+    {
+        return region;
+    }
+
+    FilterParameters getFilter() const
+    {
+        return filter;
+    }
+
+    LoadState getLoadState() const
+    {
+        return static_cast<LoadState>(juce::jlimit(0, 3, static_cast<int>(loadState))); 
+    }
+
+    juce::String getLoadError() const
+    {
+        return loadError; 
+    }
+
     double getHZoom()
     {
         return hZoom; 
@@ -441,6 +730,11 @@ private:
                 listenerList.call([&](Listener& l) { l.fileChanged(audioFile); });
                 return;
             }
+            else if (property == IDs::zones)
+            {
+                zoneFiles.forceUpdateOfCachedValue();
+                return;
+            }
             else if(property == IDs::isActive)
             {
                 isActiveSample.forceUpdateOfCachedValue(); 
@@ -458,11 +752,50 @@ private:
                 adsr.forceUpdateOfCachedValue(); 
                 listenerList.call([&](Listener& l) { l.adsrChanged(adsr); });
             }
+            else if (property == IDs::envelopeCurve)
+            {
+                envelopeCurve.forceUpdateOfCachedValue();
+                listenerList.call([&](Listener& l) { l.envelopeCurveChanged(getEnvelopeCurve()); });
+            }
             else if (property == IDs::pitchShift)
             {
                 pitchShift.forceUpdateOfCachedValue(); 
                 listenerList.call([&](Listener& l) { l.pitchShiftChanged(pitchShift); });
             }
+            else if (property == IDs::gain)
+            {
+                gain.forceUpdateOfCachedValue();
+                listenerList.call([&](Listener& l) { l.gainChanged(gain); });
+            }
+            else if (property == IDs::interpolation)
+            {
+                interpolation.forceUpdateOfCachedValue(); 
+                listenerList.call([&](Listener& l) { l.interpolationModeChanged(getInterpolationMode()); });
+            }
+            else if (property == IDs::region)
+            {
+                region.forceUpdateOfCachedValue();
+                listenerList.call([&](Listener& l) { l.regionChanged(region); });
+            }
+            else if (property == IDs::totalRange)
+            {
+                totalRange.forceUpdateOfCachedValue();
+                listenerList.call([&](Listener& l) { l.totalRangeChanged(totalRange); });
+            }
+            else if (property == IDs::filter)
+            {
+                filter.forceUpdateOfCachedValue();
+                listenerList.call([&](Listener& l) { l.filterChanged(filter); });
+            }
+            else if (property == IDs::loadState)
+            {
+                loadState.forceUpdateOfCachedValue(); 
+                listenerList.call([&](Listener& l) { l.loadStateChanged(getLoadState()); });
+            }
+            else if (property == IDs::loadError)
+            {
+                loadError.forceUpdateOfCachedValue(); 
+            }
             else if (property == IDs::hZoom)
             {
                 hZoom.forceUpdateOfCachedValue(); 
@@ -477,9 +810,17 @@ private:
     juce::CachedValue<int> id; 
     juce::CachedValue<juce::String> name;
     juce::CachedValue<std::shared_ptr<juce::File>> audioFile;
+    juce::CachedValue<std::vector<ZoneFile>> zoneFiles;
     juce::CachedValue<int> midiNote; 
     juce::CachedValue<ADSRParameters> adsr; 
-    juce::CachedValue<int> pitchShift; 
+    juce::CachedValue<int> envelopeCurve;
+    juce::CachedValue<int> pitchShift;
+    juce::CachedValue<float> gain; 
+    juce::CachedValue<int> interpolation; 
+    juce::CachedValue<SampleRegion> region;
+    juce::CachedValue<FilterParameters> filter;
+    juce::CachedValue<int> loadState; 
+    juce::CachedValue<juce::String> loadError; 
     juce::CachedValue<bool> isActiveSample; 
     juce::CachedValue<juce::Range<double>> totalRange;
     juce::CachedValue<double> hZoom;
@@ -499,6 +840,7 @@ public:
         virtual ~Listener() noexcept = default;
         virtual void activeSampleChanged(SampleModel&) {}
         virtual void fileChanged(SampleModel&) {}
+        virtual void settingChanged(const juce::Identifier&) {}
     };
 
     explicit DataModel()
@@ -535,6 +877,33 @@ public:
         }
     }
 
+    juce::ValueTree getSampleTree(int sampleId) const
+    {
+        return getState().getChildWithProperty(IDs::id, sampleId); 
+    }
+
+    //============ Instance settings ============
+    // Held on the DATA_MODEL tree itself, so the processor hears of them
+    // like any other change to the model.
+    void setRenderThreads(int numThreads)
+    {
+        getState().setProperty(IDs::renderThreads, numThreads, nullptr);
+    }
+
+    int getRenderThreads() const
+    {
+        return getState().getProperty(IDs::renderThreads, 0);
+    }
+
+    void setEmbedSamples(bool shouldEmbed)
+    {
+        getState().setProperty(IDs::embedSamples, shouldEmbed, nullptr);
+    }
+
+    bool getEmbedSamples() const
+    {
+        return getState().getProperty(IDs::embedSamples, false);
+    }
     
     //============Listener Methods============
     void addListener(Listener& listener)
@@ -566,6 +935,10 @@ private:
             }
             
         }
+        else if (treeChanged == getState())
+        {
+            listenerList.call([&](Listener& l) { l.settingChanged(property); });
+        }
         return; 
     }
 
@@ -574,10 +947,26 @@ private:
 };
 
 
-struct PlaybackData
+// A sounding voice, as the audio thread last saw it.
+struct VoicePlayhead
 {
-    float playbackPosition; 
-    float midiNote; 
+    int padId = -1;
+    int midiNote = -1;
+    float position = 0.0f;         // Seconds from the start of the file
+    float envelopeLevel = 0.0f;
+};
+
+// Every sounding voice at the end of one block, published together so a
+// reader never mixes the state of one block or voice with another's.
+struct PlaybackSnapshot
+{
+    static constexpr int maxVoices = 256;
+
+    // The host's time for the block in nanoseconds, or the system's
+    // high-resolution clock if the host does not provide one.
+    juce::uint64 timeNs = 0;
+    int numVoices = 0;
+    std::array<VoicePlayhead, maxVoices> voices;
 };
 
 //void  initializeDefaultModel(DataModel& dataModel, int numSamples)
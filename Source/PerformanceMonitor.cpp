@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    PerformanceMonitor.cpp
+    Created: 18 Oct 2026 2:41:27am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "PerformanceMonitor.h"
+
+namespace
+{
+    struct Registry
+    {
+        juce::CriticalSection lock;
+        juce::Array<PerformanceMonitor*> monitors;
+        int nextId = 1;
+    };
+
+    Registry& getRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    int getVoiceBucket(int numVoices) noexcept
+    {
+        if (numVoices <= 0)
+            return 0;
+
+        // 1 -> 1, 2-3 -> 2, 4-7 -> 3, ...
+        int bucket = 1;
+
+        while (numVoices > 1 && bucket < PerformanceMonitor::numVoiceBuckets - 1)
+        {
+            numVoices >>= 1;
+            ++bucket;
+        }
+
+        return bucket;
+    }
+}
+
+PerformanceMonitor::PerformanceMonitor()
+    : instanceId([]
+        {
+            auto& registry = getRegistry();
+            const juce::ScopedLock sl(registry.lock);
+            return registry.nextId++;
+        }())
+{
+    auto& registry = getRegistry();
+    const juce::ScopedLock sl(registry.lock);
+    registry.monitors.add(this);
+}
+
+PerformanceMonitor::~PerformanceMonitor()
+{
+    auto& registry = getRegistry();
+    const juce::ScopedLock sl(registry.lock);
+    registry.monitors.removeFirstMatchingValue(this);
+}
+
+void PerformanceMonitor::addBlock(const Block& block) noexcept
+{
+    if (resetRequested.exchange(false, std::memory_order_relaxed))
+        clear();
+
+    if (block.budgetSeconds <= 0.0)
+        return;
+
+    const auto load = (float)(block.elapsedSeconds / block.budgetSeconds);
+
+    add(numBlocks, (juce::int64)1);
+    lastLoad.store(load, std::memory_order_relaxed);
+    add(totalLoad, (double)load);
+    raise(maxLoad, load);
+
+    if (load > overrunThreshold.load(std::memory_order_relaxed))
+    {
+        add(numOverruns, (juce::int64)1);
+
+        // Wall-clock time, so an overrun can be matched against the host's
+        // own dropout log. Reading the clock neither locks nor allocates.
+        lastOverrunTime.store(juce::Time::currentTimeMillis(), std::memory_order_relaxed);
+    }
+
+    const auto loadBucket = juce::jlimit(0, numLoadBuckets - 1, (int)(load * 10.0f));
+    add(loadHistogram[(size_t)loadBucket], (juce::uint32)1);
+    add(voiceHistogram[(size_t)getVoiceBucket(block.numActiveVoices)], (juce::uint32)1);
+
+    raise(maxActiveVoices, block.numActiveVoices);
+    add(numSteals, (juce::int64)block.numSteals);
+    raise(maxCommandQueueDepth, block.commandQueueDepth);
+}
+
+void PerformanceMonitor::clear() noexcept
+{
+    numBlocks.store(0, std::memory_order_relaxed);
+    numOverruns.store(0, std::memory_order_relaxed);
+    lastOverrunTime.store(0, std::memory_order_relaxed);
+    lastLoad.store(0.0f, std::memory_order_relaxed);
+    totalLoad.store(0.0, std::memory_order_relaxed);
+    maxLoad.store(0.0f, std::memory_order_relaxed);
+    maxActiveVoices.store(0, std::memory_order_relaxed);
+    numSteals.store(0, std::memory_order_relaxed);
+    maxCommandQueueDepth.store(0, std::memory_order_relaxed);
+
+    for (auto& count : loadHistogram)
+        count.store(0, std::memory_order_relaxed);
+
+    for (auto& count : voiceHistogram)
+        count.store(0, std::memory_order_relaxed);
+}
+
+PerformanceMonitor::Report PerformanceMonitor::getReport() const
+{
+    Report report;
+    report.instanceId = instanceId;
+    report.numBlocks = numBlocks.load(std::memory_order_relaxed);
+    report.numOverruns = numOverruns.load(std::memory_order_relaxed);
+    report.lastOverrunTime = lastOverrunTime.load(std::memory_order_relaxed);
+    report.overrunThreshold = overrunThreshold.load(std::memory_order_relaxed);
+    report.lastLoad = lastLoad.load(std::memory_order_relaxed);
+    report.maxLoad = maxLoad.load(std::memory_order_relaxed);
+    report.maxActiveVoices = maxActiveVoices.load(std::memory_order_relaxed);
+    report.numSteals = numSteals.load(std::memory_order_relaxed);
+    report.maxCommandQueueDepth = maxCommandQueueDepth.load(std::memory_order_relaxed);
+
+    if (report.numBlocks > 0)
+        report.meanLoad = (float)(totalLoad.load(std::memory_order_relaxed) / (double)report.numBlocks);
+
+    for (size_t i = 0; i < loadHistogram.size(); ++i)
+        report.loadHistogram[i] = loadHistogram[i].load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < voiceHistogram.size(); ++i)
+        report.voiceHistogram[i] = voiceHistogram[i].load(std::memory_order_relaxed);
+
+    return report;
+}
+
+std::vector<PerformanceMonitor::Report> PerformanceMonitor::getAllReports()
+{
+    auto& registry = getRegistry();
+    const juce::ScopedLock sl(registry.lock);
+
+    std::vector<Report> reports;
+    reports.reserve((size_t)registry.monitors.size());
+
+    for (auto* monitor : registry.monitors)
+        reports.push_back(monitor->getReport());
+
+    return reports;
+}
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    PerformanceMonitor.h
+    Created: 18 Oct 2026 2:41:27am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+//=====================================================================
+// Per-block statistics for one plugin instance. The audio thread adds a
+// block at a time with plain relaxed atomic stores, so recording costs a
+// few dozen instructions and never blocks. Any other thread may read a
+// Report at any time; its counters are each exact, but may be a block
+// apart from one another.
+//
+// Every monitor in the process is registered, so when a session drops
+// out, getAllReports shows which instance overran its budget and when.
+// Instances share the host's block, so one of several can cause a dropout
+// without using the whole block itself: a block counts as an overrun once
+// its load passes a threshold, which may be set below 100%.
+class PerformanceMonitor
+{
+public:
+    // Block time as a share of the block's duration, in 10% steps; the
+    // last bucket holds every block that took longer than its duration.
+    static constexpr int numLoadBuckets = 11;
+
+    // Active voices: 0, 1, 2-3, 4-7, ... 128-255, 256 and up.
+    static constexpr int numVoiceBuckets = 10;
+
+    struct Block
+    {
+        double elapsedSeconds = 0.0;
+        double budgetSeconds = 0.0;    // The block's length in real time
+        int numActiveVoices = 0;
+        int numSteals = 0;             // Voices stolen during the block
+        int commandQueueDepth = 0;     // Commands waiting at its start
+    };
+
+    struct Report
+    {
+        int instanceId = 0;
+        juce::int64 numBlocks = 0;
+        juce::int64 numOverruns = 0;
+        juce::int64 lastOverrunTime = 0;    // Milliseconds since 1970, or 0
+        float overrunThreshold = 1.0f;
+        float lastLoad = 0.0f;
+        float meanLoad = 0.0f;
+        float maxLoad = 0.0f;
+        int maxActiveVoices = 0;
+        juce::int64 numSteals = 0;
+        int maxCommandQueueDepth = 0;
+
+        // Filled in by the owner, from outside the audio thread.
+        int numFailedCommandPushes = 0;
+        int loaderBacklog = 0;
+        int numStreamUnderruns = 0;
+
+        std::array<juce::uint32, numLoadBuckets> loadHistogram {};
+        std::array<juce::uint32, numVoiceBuckets> voiceHistogram {};
+    };
+
+    PerformanceMonitor();
+    ~PerformanceMonitor();
+
+    // Audio thread.
+    void addBlock(const Block&) noexcept;
+
+    // Any thread.
+    Report getReport() const;
+    int getInstanceId() const noexcept { return instanceId; }
+
+    // Any thread. Cleared by the audio thread at its next block.
+    void reset() noexcept { resetRequested.store(true, std::memory_order_relaxed); }
+
+    // Any thread. The load, as a share of the block's duration, above which
+    // a block counts as an overrun. Blocks already counted are kept.
+    static constexpr float defaultOverrunThreshold = 1.0f;
+    void setOverrunThreshold(float threshold) noexcept { overrunThreshold.store(juce::jmax(0.01f, threshold), std::memory_order_relaxed); }
+    float getOverrunThreshold() const noexcept { return overrunThreshold.load(std::memory_order_relaxed); }
+
+    // Message thread. The reports of every instance in the process; the
+    // owners' fields are left empty.
+    static std::vector<Report> getAllReports();
+
+private:
+    // Single writer, so updates are a relaxed load and store rather than a
+    // read-modify-write.
+    template <typename Type>
+    static void add(std::atomic<Type>& counter, Type amount) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    template <typename Type>
+    static void raise(std::atomic<Type>& counter, Type value) noexcept
+    {
+        if (value > counter.load(std::memory_order_relaxed))
+            counter.store(value, std::memory_order_relaxed);
+    }
+
+    void clear() noexcept;
+
+    const int instanceId;
+
+    std::atomic<juce::int64> numBlocks { 0 };
+    std::atomic<juce::int64> numOverruns { 0 };
+    std::atomic<juce::int64> lastOverrunTime { 0 };
+    std::atomic<float> overrunThreshold { defaultOverrunThreshold };
+    std::atomic<float> lastLoad { 0.0f };
+    std::atomic<double> totalLoad { 0.0 };
+    std::atomic<float> maxLoad { 0.0f };
+    std::atomic<int> maxActiveVoices { 0 };
+    std::atomic<juce::int64> numSteals { 0 };
+    std::atomic<int> maxCommandQueueDepth { 0 };
+    std::array<std::atomic<juce::uint32>, numLoadBuckets> loadHistogram {};
+    std::array<std::atomic<juce::uint32>, numVoiceBuckets> voiceHistogram {};
+
+    std::atomic<bool> resetRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerformanceMonitor)
+};
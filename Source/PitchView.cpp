@@ -25,7 +25,18 @@ PitchView::PitchView(const DataModel& dm)
     mPitchSlider.addListener(this);
     mPitchSlider.getProperties().set("shouldDrawValue", true);
     addAndMakeVisible(mPitchSlider);
-    
+
+    mInterpolationLabel.setText("Interpolation", juce::dontSendNotification);
+    mInterpolationLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(mInterpolationLabel);
+
+    // Item ids are InterpolationMode values + 1, since ComboBox reserves 0.
+    mInterpolationSelect.addItem("Linear", static_cast<int>(InterpolationMode::linear) + 1);
+    mInterpolationSelect.addItem("Hermite", static_cast<int>(InterpolationMode::hermite) + 1);
+    mInterpolationSelect.addItem("Sinc", static_cast<int>(InterpolationMode::sinc) + 1);
+    mInterpolationSelect.setSelectedId(static_cast<int>(InterpolationMode::linear) + 1, juce::dontSendNotification);
+    mInterpolationSelect.onChange = [this] { interpolationMenuChanged(); };
+    addAndMakeVisible(mInterpolationSelect);
 }
 
 PitchView::~PitchView()
@@ -57,7 +68,10 @@ void PitchView::resized()
     grid.templateRows = { Track(Fr(3)), Track(Fr(1)), Track(Fr(3)), Track(Fr(1)) };
     grid.templateColumns = { Track(Fr(1)), Track(Fr(1)), Track(Fr(1)), Track(Fr(1)) };
     grid.items = { juce::GridItem(mPitchSlider).withArea(1,1), 
-                   juce::GridItem(mPitchLabel).withArea(2,1)
+                   juce::GridItem(mPitchLabel).withArea(2,1),
+                   juce::GridItem(mInterpolationSelect).withArea(1,2).withHeight(24).withAlignSelf(juce::GridItem::AlignSelf::center)
+                                                         .withMargin(juce::GridItem::Margin(0, spacing::padding3, 0, spacing::padding3)),
+                   juce::GridItem(mInterpolationLabel).withArea(2,2)
     };
 
     grid.performLayout(getLocalBounds().reduced(spacing::padding3));
@@ -71,6 +85,7 @@ void PitchView::nameChanged(juce::String)
 void PitchView::activeSampleChanged(SampleModel& sm)
 {
     mPitchSlider.setValue(sm.getPitchShift());
+    mInterpolationSelect.setSelectedId(static_cast<int>(sm.getInterpolationMode()) + 1, juce::dontSendNotification);
 
     if (mActiveSample != nullptr)
         mActiveSample->removeListener(*this);
@@ -93,10 +108,17 @@ void PitchView::sliderValueChanged(juce::Slider* sliderChanged)
     }
 }
 
+void PitchView::interpolationMenuChanged()
+{
+    if (mActiveSample != nullptr)
+        mActiveSample->setInterpolationMode(static_cast<InterpolationMode>(mInterpolationSelect.getSelectedId() - 1));
+}
+
 void PitchView::lookAndFeelChanged()
 {
     if (!dynamic_cast<juce::LookAndFeel_V4*>(&getLookAndFeel()))
     {
         mPitchLabel.setColour(juce::Label::textColourId, getLookAndFeel().findColour(AppColors::ColourIds::TextPrimary));
+        mInterpolationLabel.setColour(juce::Label::textColourId, getLookAndFeel().findColour(AppColors::ColourIds::TextPrimary));
     }
 }
@@ -36,8 +36,12 @@ private:
     // Slider listener 
     void sliderValueChanged(juce::Slider*) override;
 
+    void interpolationMenuChanged();
+
     juce::Slider mPitchSlider;
     juce::Label mPitchLabel;
+    juce::ComboBox mInterpolationSelect;
+    juce::Label mInterpolationLabel;
 
     DataModel mDataModel;
     std::unique_ptr<SampleModel> mActiveSample;
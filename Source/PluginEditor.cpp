@@ -11,14 +11,16 @@
 
 //==============================================================================
 WalsheeySampleAudioProcessorEditor::WalsheeySampleAudioProcessorEditor (WalsheeySampleAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p), mMainSamplerView(mDataModel, [&p] { return p.getPlaybackPosition(); })
+    : AudioProcessorEditor(&p), mDataModel(p.getDataModel()),
+    mMainSamplerView(mDataModel,
+        [&p]() -> const PlaybackSnapshot& { return p.getPlaybackSnapshot(); },
+        [&p] { return p.getPerformanceReport(); },
+        [&p] { p.resetPerformanceStats(); },
+        [&p](float threshold) { p.setOverrunThreshold(threshold); }),
+    audioProcessor(p)
 {
     setLookAndFeel(&mLF);
     mMainSamplerView.setLookAndFeel(&mLF); 
-    mFormatManager.registerBasicFormats(); 
-
-    mDataModel.addListener(*this); 
-    mDataModel.initializeDefaultModel(8);
 
     addAndMakeVisible(mMainSamplerView); 
     
@@ -41,32 +43,3 @@ void WalsheeySampleAudioProcessorEditor::resized()
 {
     mMainSamplerView.setBounds(getLocalBounds()); 
 }
-
-void WalsheeySampleAudioProcessorEditor::fileChanged(SampleModel& ModelChanged)
-{
-    auto file = ModelChanged.getAudioFile(); 
-    if (file->exists())
-        audioProcessor.setSample(std::unique_ptr<juce::AudioFormatReader>(mFormatManager.createReaderFor(*file)), ModelChanged.getMidiNote(), ModelChanged.getId());
-
-}
-
-void WalsheeySampleAudioProcessorEditor::activeSampleChanged(SampleModel& sm)
-{
-    if (mActiveSample != nullptr)
-        mActiveSample->removeListener(*this);
-
-    mActiveSample = std::make_unique<SampleModel>(sm.getState());
-
-    if (mActiveSample != nullptr)
-        mActiveSample->addListener(*this);
-}
-
-void WalsheeySampleAudioProcessorEditor::adsrChanged(ADSRParameters adsrParams)
-{
-   audioProcessor.setADSR(adsrParams, mActiveSample->getId()); 
-}
-
-void WalsheeySampleAudioProcessorEditor::pitchShiftChanged(int semitones)
-{
-    audioProcessor.setPitchShift(semitones, mActiveSample->getId()); 
-}
\ No newline at end of file
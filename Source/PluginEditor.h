@@ -18,10 +18,7 @@
 //==============================================================================
 /**
 */
-class WalsheeySampleAudioProcessorEditor  : public juce::AudioProcessorEditor, 
-                                            private DataModel::Listener,
-                                            private SampleModel::Listener
-                                                                        
+class WalsheeySampleAudioProcessorEditor  : public juce::AudioProcessorEditor
 {
 public:
     WalsheeySampleAudioProcessorEditor (WalsheeySampleAudioProcessor&);
@@ -32,19 +29,9 @@ public:
     void resized() override;
 
 private:
-    //Data model listener
-    void activeSampleChanged(SampleModel&) override;
-    void fileChanged(SampleModel&) override; 
-
-    //Sample model listener
-    virtual void adsrChanged(ADSRParameters) override; 
-    virtual void pitchShiftChanged(int) override; 
-
     DarkLookAndFeel mLF; 
 
     DataModel mDataModel;
-    std::unique_ptr<SampleModel> mActiveSample; 
-    juce::AudioFormatManager mFormatManager; 
     MainSamplerView mMainSamplerView; 
 
     WalsheeySampleAudioProcessor& audioProcessor;
@@ -9,6 +9,34 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+namespace
+{
+    // Struct properties are only present once they have been set.
+    template <typename Type>
+    Type getSampleProperty(const juce::ValueTree& sampleTree, const juce::Identifier& property)
+    {
+        if (!sampleTree.hasProperty(property))
+            return {};
+
+        return juce::VariantConverter<Type>::fromVar(sampleTree[property]);
+    }
+
+    InterpolationMode getInterpolationProperty(const juce::ValueTree& sampleTree)
+    {
+        return static_cast<InterpolationMode>(juce::jlimit(0, 2, static_cast<int>(sampleTree.getProperty(IDs::interpolation, 0))));
+    }
+
+    EnvelopeCurve getEnvelopeCurveProperty(const juce::ValueTree& sampleTree)
+    {
+        return static_cast<EnvelopeCurve>(juce::jlimit(0, 1, static_cast<int>(sampleTree.getProperty(IDs::envelopeCurve, 0))));
+    }
+
+    BlockEnvelope::Curve toBlockCurve(EnvelopeCurve curve) noexcept
+    {
+        return curve == EnvelopeCurve::exponential ? BlockEnvelope::Curve::exponential : BlockEnvelope::Curve::linear;
+    }
+}
+
 //==============================================================================
 WalsheeySampleAudioProcessor::WalsheeySampleAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -20,14 +48,66 @@ WalsheeySampleAudioProcessor::WalsheeySampleAudioProcessor()
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        ), 
-       playbackPosition(0)
+       mParameters(*this, nullptr, "PARAMETERS", createParameterLayout())
 #endif
 {
-    mSampler.addVoice(new ExtendedSamplerVoice());
+    for (int pad = 0; pad < numPads; ++pad)
+    {
+        auto& parameters = mPadParameters[(size_t)pad];
+        auto find = [this, pad](const juce::String& name, auto*& result)
+        {
+            result = dynamic_cast<std::remove_reference_t<decltype(result)>> (mParameters.getParameter(getParameterID(pad, name)));
+            jassert(result != nullptr);
+        };
+
+        find("Attack", parameters.attack);
+        find("Decay", parameters.decay);
+        find("Sustain", parameters.sustain);
+        find("Release", parameters.release);
+        find("Curve", parameters.curve);
+        find("Pitch", parameters.pitch);
+        find("Gain", parameters.gain);
+        find("FilterMode", parameters.filterMode);
+        find("Cutoff", parameters.cutoff);
+        find("Resonance", parameters.resonance);
+        find("FilterEnvelope", parameters.filterEnvelope);
+        find("FilterVelocity", parameters.filterVelocity);
+    }
+
+    mDataModel.initializeDefaultModel(numPads);
+    mDataModel.getState().addListener(this);
+    mLoader.addListener(*this);
+
+    mLoader.onSoundReady = [this](ExtendedSamplerSound::Ptr sound)
+    {
+        const bool keepSettings = std::exchange(mKeepPadSettings[(size_t)sound->getId()], true);
+
+        // A new file starts from the pad's settings in the model.
+        if (!keepSettings)
+            applyModelSettings(*sound);
+
+        setSound(std::move(sound), keepSettings);
+    };
+
+    // The host's next save will include the newly encoded audio.
+    mEncoder.onEncoded = [this]
+    {
+        mStateChanged = true;
+        updateHostDisplay(ChangeDetails().withNonParameterStateChanged(true));
+    };
+
+    updateStateSnapshot();
+
+    // Follows host automation in the model; anything the audio thread lets
+    // go of is freed from here too.
+    startTimerHz(30);
 }
 
 WalsheeySampleAudioProcessor::~WalsheeySampleAudioProcessor()
 {
+    cancelPendingUpdate();
+    mLoader.removeListener(*this);
+    mDataModel.getState().removeListener(this);
 }
 
 //==============================================================================
@@ -95,7 +175,14 @@ void WalsheeySampleAudioProcessor::changeProgramName (int index, const juce::Str
 //==============================================================================
 void WalsheeySampleAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    mSampler.setStreamReadAhead(mRequestedReadAhead.load());
+    mSampler.setVoiceCount(mRequestedNumVoices.load());
+    mSampler.setNumRenderThreads(mRequestedRenderThreads.load());
     mSampler.setCurrentPlaybackSampleRate(sampleRate);
+    mSampler.prepareRenderThreads(getTotalNumOutputChannels(), samplesPerBlock);
+
+    // Picked up by the timer, which reloads the pads at the new rate.
+    mHostSampleRate = sampleRate;
 }
 
 void WalsheeySampleAudioProcessor::releaseResources()
@@ -133,6 +220,10 @@ bool WalsheeySampleAudioProcessor::isBusesLayoutSupported (const BusesLayout& la
 void WalsheeySampleAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    const int numQueuedCommands = mCommands.getNumReady();
+    const int numStealsBefore = mSampler.getNumSteals();
+
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -140,6 +231,17 @@ void WalsheeySampleAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
         buffer.clear (i, 0, buffer.getNumSamples());
 
     process(buffer, midiMessages); 
+
+    if (getSampleRate() <= 0.0)
+        return;
+
+    PerformanceMonitor::Block block;
+    block.elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    block.budgetSeconds = buffer.getNumSamples() / getSampleRate();
+    block.numActiveVoices = mSampler.getNumActiveVoices();
+    block.numSteals = mSampler.getNumSteals() - numStealsBefore;
+    block.commandQueueDepth = numQueuedCommands;
+    mPerformance.addBlock(block);
 }
 
 //==============================================================================
@@ -150,22 +252,325 @@ bool WalsheeySampleAudioProcessor::hasEditor() const
 
 juce::AudioProcessorEditor* WalsheeySampleAudioProcessor::createEditor()
 {
-    juce::SpinLock::ScopedLockType lock(mCommandQueueMutex);
     return new WalsheeySampleAudioProcessorEditor (*this);
 }
 
 //==============================================================================
 void WalsheeySampleAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    {
+        // A chunk that has not been restored yet is still the current state.
+        const juce::ScopedLock sl(mPendingStateLock);
+
+        if (!mPendingState.isEmpty())
+        {
+            destData = mPendingState;
+            return;
+        }
+    }
+
+    // Hosts may save from any thread, so other threads write the snapshot
+    // the message thread keeps of the model and the pads' files.
+    KitState kit;
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        updateStateSnapshot();
+
+    {
+        const juce::ScopedLock sl(mStateLock);
+        kit = mStateSnapshot;
+    }
+
+    juce::MemoryOutputStream out(destData, false);
+    PluginState::write(kit, out);
 }
 
 void WalsheeySampleAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    // Hosts restore every instance of a project in a row, so this only
+    // copies the chunk. The model is updated and the samples are queued for
+    // decoding from the message thread afterwards.
+    {
+        const juce::ScopedLock sl(mPendingStateLock);
+        mPendingState.replaceAll(data, (size_t)juce::jmax(0, sizeInBytes));
+    }
+
+    triggerAsyncUpdate();
+}
+
+void WalsheeySampleAudioProcessor::handleAsyncUpdate()
+{
+    juce::MemoryBlock chunk;
+
+    {
+        const juce::ScopedLock sl(mPendingStateLock);
+        chunk.swapWith(mPendingState);
+    }
+
+    KitState kit;
+
+    if (!PluginState::read(chunk.getData(), chunk.getSize(), kit))
+        return;
+
+    const juce::ScopedValueSetter<bool> restoring(mIsRestoring, true);
+    // Set before the model, so the restore does not start encoding the
+    // pads it is about to replace.
+    mEmbedSamples = kit.embedSamples;
+    mDataModel.setEmbedSamples(kit.embedSamples);
+    mDataModel.setRenderThreads(kit.numRenderThreads);
+
+    for (const auto& pad : kit.pads)
+    {
+        auto sampleTree = mDataModel.getSampleTree(pad.id);
+
+        if (!sampleTree.isValid())
+            continue;
+
+        SampleModel sample(sampleTree);
+        sample.setName(pad.name);
+        sample.setMidiNote(pad.midiNote);
+        sample.setADSR(pad.adsr);
+        sample.setEnvelopeCurve(pad.envelopeCurve);
+        sample.setPitchShift(pad.pitchShift);
+        sample.setGain(pad.gain);
+        sample.setInterpolationMode(pad.interpolation);
+        sample.setRegion(pad.region);
+        sample.setFilter(pad.filter);
+
+        // Restoring over a live instance must not leave a pad the state
+        // has no sample for playing its old one.
+        if (pad.zones.empty())
+        {
+            sample.clearAudioFile();
+            sample.setLoadState(LoadState::empty);
+            clearPad(pad.id);
+            continue;
+        }
+
+        // The saved hashes let the pool match files whose size and time are
+        // unchanged without reading them again.
+        std::vector<SampleZone> zones;
+        std::vector<ZoneFile> zoneFiles;
+
+        for (const auto& zone : pad.zones)
+        {
+            zoneFiles.push_back({ zone.file, zone.lowVelocity, zone.highVelocity });
+            mLoader.addKnownFile(zone.file, zone.identity);
+            SampleZone restored { zone.file, zone.lowVelocity, zone.highVelocity };
+
+            if (zone.embeddedAudio != nullptr)
+            {
+                // Kept so that saving again does not encode the file again.
+                mEncoder.add(zone.file, { zone.identity, zone.embeddedAudio });
+
+                // The file is preferred while it is still the one that was
+                // embedded, since it may be mapped or streamed.
+                if (!zone.file.existsAsFile() || !zone.identity.matches(zone.file))
+                    restored.embeddedAudio = zone.embeddedAudio;
+            }
+
+            zones.push_back(std::move(restored));
+        }
+
+        // Each pad plays as soon as its first layer has been decoded.
+        sample.restoreAudioFiles(zoneFiles, { 0.0, pad.lengthSeconds });
+        sample.setLoadState(LoadState::loading);
+        setSampleZones(zones, sample.getMidiNote(), pad.id);
+    }
+
+    updateEncodedFiles();
+    mStateChanged = true;
+}
+
+void WalsheeySampleAudioProcessor::updateStateSnapshot()
+{
+    auto kit = makeState();
+
+    const juce::ScopedLock sl(mStateLock);
+    mStateSnapshot = std::move(kit);
+    mStateChanged = false;
+}
+
+KitState WalsheeySampleAudioProcessor::makeState()
+{
+    KitState kit;
+    kit.embedSamples = mEmbedSamples;
+    kit.numRenderThreads = mRequestedRenderThreads;
+
+    for (const auto& sampleTree : mDataModel.getState())
+    {
+        SampleModel sample(sampleTree);
+
+        PadState pad;
+        pad.id = sample.getId();
+        pad.name = sample.getName();
+        pad.midiNote = sample.getMidiNote();
+        pad.adsr = sample.getADSR();
+        pad.envelopeCurve = sample.getEnvelopeCurve();
+        pad.pitchShift = sample.getPitchShift();
+        pad.gain = sample.getGain();
+        pad.interpolation = sample.getInterpolationMode();
+        pad.region = sample.getRegion();
+        pad.filter = sample.getFilter();
+        pad.lengthSeconds = sample.getTotalRange().getEnd();
+
+        if (juce::isPositiveAndBelow(pad.id, SamplerSynthesiser::maxPads))
+        {
+            for (const auto& zone : mPadFiles[(size_t)pad.id].zones)
+            {
+                PadState::Zone saved { zone.file, zone.lowVelocity, zone.highVelocity, mLoader.getKnownFile(zone.file) };
+
+                // Only what has already been encoded is embedded; the rest
+                // is queued, so saving never waits on an encode.
+                if (kit.embedSamples)
+                {
+                    const auto encoded = mEncoder.find(zone.file);
+
+                    if (encoded.flac != nullptr)
+                    {
+                        saved.identity = encoded.identity;
+                        saved.embeddedAudio = encoded.flac;
+                    }
+                    else
+                    {
+                        mEncoder.request(zone.file, saved.identity);
+                    }
+                }
+
+                pad.zones.push_back(std::move(saved));
+            }
+        }
+
+        kit.pads.push_back(std::move(pad));
+    }
+
+    return kit;
+}
+
+void WalsheeySampleAudioProcessor::setEmbedSamples(bool shouldEmbed)
+{
+    mDataModel.setEmbedSamples(shouldEmbed);
+}
+
+void WalsheeySampleAudioProcessor::embedSamplesChanged(bool shouldEmbed)
+{
+    mEmbedSamples = shouldEmbed;
+    mStateChanged = true;
+    updateEncodedFiles();
+
+    // Encoding starts now rather than at the next save.
+    for (int id = 0; id < SamplerSynthesiser::maxPads; ++id)
+        requestEncoding(id);
+}
+
+void WalsheeySampleAudioProcessor::requestEncoding(int id)
+{
+    if (!mEmbedSamples || !juce::isPositiveAndBelow(id, SamplerSynthesiser::maxPads))
+        return;
+
+    for (const auto& zone : mPadFiles[(size_t)id].zones)
+        mEncoder.request(zone.file, mLoader.getKnownFile(zone.file));
+}
+
+void WalsheeySampleAudioProcessor::updateEncodedFiles()
+{
+    // Drops the encoded audio of files no pad plays any more.
+    juce::StringArray paths;
+
+    if (mEmbedSamples)
+        for (const auto& pad : mPadFiles)
+            for (const auto& zone : pad.zones)
+                paths.addIfNotAlreadyThere(zone.file.getFullPathName());
+
+    mEncoder.retainOnly(paths);
+}
+
+void WalsheeySampleAudioProcessor::valueTreePropertyChanged(juce::ValueTree& sampleTree, const juce::Identifier& property)
+{
+    if (sampleTree == mDataModel.getState())
+    {
+        mStateChanged = true;
+
+        if (property == IDs::renderThreads)
+            setNumRenderThreads(mDataModel.getRenderThreads());
+        else if (property == IDs::embedSamples && mDataModel.getEmbedSamples() != mEmbedSamples)
+            embedSamplesChanged(mDataModel.getEmbedSamples());
+
+        return;
+    }
+
+    if (!sampleTree.hasType(IDs::SAMPLE))
+        return;
+
+    mStateChanged = true;
+    const int id = sampleTree[IDs::id];
+
+    if (property == IDs::file)
+    {
+        // A restore loads the pad's saved zones itself.
+        if (mIsRestoring)
+            return;
+
+        auto file = getSampleProperty<std::shared_ptr<juce::File>>(sampleTree, IDs::file);
+
+        if (file != nullptr && file->exists())
+        {
+            SampleModel sample(sampleTree);
+            sample.setLoadState(LoadState::loading);
+
+            // The model's zones are set along with their first file.
+            const auto zoneFiles = sample.getZoneFiles();
+            std::vector<SampleZone> zones;
+
+            if (!zoneFiles.empty() && zoneFiles.front().file == *file)
+                for (const auto& zone : zoneFiles)
+                    zones.push_back({ zone.file, zone.lowVelocity, zone.highVelocity });
+            else
+                zones.push_back({ *file });
+
+            setSampleZones(zones, sampleTree[IDs::midiNote], id);
+        }
+    }
+    else if (property == IDs::adsr)
+    {
+        setADSR(getSampleProperty<ADSRParameters>(sampleTree, IDs::adsr), id);
+    }
+    else if (property == IDs::envelopeCurve)
+    {
+        setEnvelopeCurve(getEnvelopeCurveProperty(sampleTree), id);
+    }
+    else if (property == IDs::pitchShift)
+    {
+        setPitchShift(sampleTree[IDs::pitchShift], id);
+    }
+    else if (property == IDs::gain)
+    {
+        setGain(sampleTree[IDs::gain], id);
+    }
+    else if (property == IDs::interpolation)
+    {
+        setInterpolationMode(getInterpolationProperty(sampleTree), id);
+    }
+    else if (property == IDs::region)
+    {
+        setSampleRegion(getSampleProperty<SampleRegion>(sampleTree, IDs::region), id);
+    }
+    else if (property == IDs::filter)
+    {
+        setFilter(getSampleProperty<FilterParameters>(sampleTree, IDs::filter), id);
+    }
+}
+
+void WalsheeySampleAudioProcessor::sampleLoadFinished(const SampleLoader::Result& result)
+{
+    auto sampleTree = mDataModel.getSampleTree(result.id);
+
+    if (sampleTree.isValid())
+        SampleModel(sampleTree).setLoadState(result.state, result.error);
+
+    // Once loaded, the files' hashes are known and need not be read again.
+    if (result.state == LoadState::ready)
+        requestEncoding(result.id);
 }
 
 //==============================================================================
@@ -176,128 +581,532 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 }
 
 
-void WalsheeySampleAudioProcessor::setSample(std::unique_ptr<juce::AudioFormatReader> reader, int midiNote, int id)
+void WalsheeySampleAudioProcessor::setSample(const juce::File& file, int midiNote, int id)
+{
+    setSampleZones({ SampleZone { file } }, midiNote, id);
+}
+
+void WalsheeySampleAudioProcessor::setSampleZones(const std::vector<SampleZone>& zones, int midiNote, int id)
+{
+    // Decoding happens on the loader's worker threads; setSound is called
+    // back on the message thread once the sound is ready.
+    if (juce::isPositiveAndBelow(id, SamplerSynthesiser::maxPads))
+    {
+        mPadFiles[(size_t)id] = { zones, midiNote };
+        mKeepPadSettings[(size_t)id] = false;
+        mStateChanged = true;
+
+        // A restore updates the encoded files once every pad is set.
+        if (!mIsRestoring)
+            updateEncodedFiles();
+    }
+
+    mLoader.load(zones, midiNote, id);
+}
+
+void WalsheeySampleAudioProcessor::clearPad(int id)
+{
+    if (!juce::isPositiveAndBelow(id, SamplerSynthesiser::maxPads))
+        return;
+
+    mLoader.cancel(id);
+    mPadFiles[(size_t)id] = {};
+    mPadSounds[(size_t)id] = nullptr;
+    mKeepPadSettings[(size_t)id] = false;
+    mStateChanged = true;
+
+    // Shares the sample command's key, so a queued sound for the pad is
+    // superseded rather than applied afterwards.
+    mCommands.push([id](WalsheeySampleAudioProcessor& proc) { proc.mSampler.clearPadSound(id); },
+        commandKey(sampleCommand, id));
+}
+
+void WalsheeySampleAudioProcessor::setSampleRegion(const SampleRegion& region, int id)
+{
+    if (!juce::isPositiveAndBelow(id, SamplerSynthesiser::maxPads))
+        return;
+
+    mPadRegions[(size_t)id] = region;
+
+    // The zones' frames are shared with the new sound; only the region and
+    // loop crossfades are worked out again.
+    const auto& current = mPadSounds[(size_t)id];
+
+    if (current != nullptr && current->getRegion() != region)
+        setSound(current->withRegion(region), true);
+}
+
+void WalsheeySampleAudioProcessor::setSound(ExtendedSamplerSound::Ptr sound, bool keepSettings)
 {
     class SetSampleCommand
     {
     public:
-        SetSampleCommand(std::unique_ptr<juce::AudioFormatReader> r, int mNote, int identifier)
-            :reader(std::move(r)), midiNote(mNote), id(identifier) {}
+        SetSampleCommand(ExtendedSamplerSound::Ptr s, bool keepPadSettings)
+            :sound(std::move(s)), keepSettings(keepPadSettings) {}
 
         void operator() (WalsheeySampleAudioProcessor& proc)
         {
-            juce::BigInteger range;
-            range.setRange(midiNote, 1, true);
-
-            for (int i = 0; i < proc.mSampler.getNumSounds(); ++i)
+            // Settings are copied here because the commands that change them
+            // are only applied on the audio thread.
+            if (auto* previous = proc.mSampler.getPadSound(sound->getId()))
             {
-                ExtendedSamplerSound* samplerSound = dynamic_cast<ExtendedSamplerSound*>(proc.mSampler.getSound(i).get());
+                if (keepSettings)
+                    sound->copySettingsFrom(*previous);
 
-                if (samplerSound != nullptr)
-                {
-                    if (samplerSound->getName() == juce::String(id))
-                    {
-                        proc.mSampler.removeSound(i);
-                        break;
-                    }
-                }
+                sound->copyRoundRobinFrom(*previous);
             }
 
-            proc.mSampler.addSound(new ExtendedSamplerSound(juce::String(id), *reader, range, midiNote, .1, .1, 10));
+            proc.mSampler.setPadSound(sound);
         }
 
-        std::unique_ptr<juce::AudioFormatReader> reader; 
-        int midiNote; 
-        int id; 
+        ExtendedSamplerSound::Ptr sound; 
+        bool keepSettings;
     };
 
-    if (reader == nullptr)
-        return; 
-    else 
-        mCommands.push(SetSampleCommand(std::move(reader), midiNote, id));
+    if (sound != nullptr)
+    {
+        // The pool outlives the audio thread's reference, so replacing or
+        // removing the sound never frees its buffer during process().
+        const int id = sound->getId();
+        const auto& region = mPadRegions[(size_t)id];
+
+        // Sounds from the loader are built with the default region.
+        if (sound->getRegion() != region)
+            sound = sound->withRegion(region);
+
+        for (int i = 0; i < sound->getNumZones(); ++i)
+            mSampler.getStreamer().registerSource(sound->getZone(i).streamSource);
+
+        mReleasePool.add(sound);
+        mPadSounds[(size_t)id] = sound;
+        mCommands.push(SetSampleCommand(std::move(sound), keepSettings), commandKey(sampleCommand, id));
+    }
 }
 
-void WalsheeySampleAudioProcessor::setADSR(ADSRParameters adsr, int id)
+void WalsheeySampleAudioProcessor::applyModelSettings(ExtendedSamplerSound& sound) const
 {
-    class SetADSRCommand
+    auto sampleTree = mDataModel.getSampleTree(sound.getId());
+
+    if (!sampleTree.isValid())
+        return;
+
+    const auto adsr = getSampleProperty<ADSRParameters>(sampleTree, IDs::adsr);
+    sound.setEnvelopeParameters(juce::ADSR::Parameters(adsr.attack, adsr.decay, adsr.sustain, adsr.release));
+    sound.setEnvelopeCurve(toBlockCurve(getEnvelopeCurveProperty(sampleTree)));
+    sound.setPitchShift(sampleTree[IDs::pitchShift]);
+    sound.setGain(juce::Decibels::decibelsToGain(static_cast<float>(sampleTree.getProperty(IDs::gain, 0.0f)), SampleModel::minGainDecibels));
+    sound.setInterpolationMode(getInterpolationProperty(sampleTree));
+    sound.setFilterParameters(getSampleProperty<FilterParameters>(sampleTree, IDs::filter));
+}
+
+StorageReport WalsheeySampleAudioProcessor::getStorageReport() const
+{
+    StorageReport report;
+    std::vector<const SampleData*> counted;
+
+    for (auto& sound : mPadSounds)
     {
-    public:
-        SetADSRCommand(ADSRParameters adsrParams, int identifier)
-            :adsr(adsrParams), id(identifier) {}
+        if (sound == nullptr)
+            continue;
 
-        void operator() (WalsheeySampleAudioProcessor& proc)
+        for (int i = 0; i < sound->getNumZones(); ++i)
         {
-            for (int i = 0; i < proc.mSampler.getNumSounds(); ++i)
+            ++report.numSounds;
+
+            // Zones that share one pooled sample only hold it once.
+            const auto* sample = sound->getZone(i).sample.get();
+
+            if (std::find(counted.begin(), counted.end(), sample) != counted.end())
             {
-                ExtendedSamplerSound* samplerSound = dynamic_cast<ExtendedSamplerSound*>(proc.mSampler.getSound(i).get());
+                ++report.numSharedSounds;
+                continue;
+            }
 
-                if (samplerSound != nullptr)
-                {
-                    if (samplerSound->getName() == juce::String(id))
-                    {
-                        samplerSound->setEnvelopeParameters(juce::ADSR::Parameters(adsr.attack, adsr.decay, adsr.sustain, adsr.release));
-                        break;
-                    }
-                }
+            counted.push_back(sample);
+
+            if (sample->isMemoryMapped())
+            {
+                report.mappedBytes += sample->getMappedBytes();
+                continue;
             }
+
+            if (sample->getStorage().encoding != SampleStorage::Encoding::float32)
+                ++report.numCompactSounds;
+
+            report.residentBytes += sample->getResidentBytes();
+            report.floatEquivalentBytes += sample->getFloatEquivalentBytes();
+            report.conversionMilliseconds += sample->getConversionMilliseconds();
         }
+    }
 
-        ADSRParameters adsr; 
-        int id; 
-    };
+    for (int e = 0; e < SampleStorage::numEncodings; ++e)
+    {
+        const auto [ticks, numSamples] = mSampler.getRenderCost(static_cast<SampleStorage::Encoding>(e));
 
-     mCommands.push(SetADSRCommand(adsr, id));
+        if (numSamples > 0)
+            report.renderNanosecondsPerSample[(size_t)e] = juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9 / (double)numSamples;
+    }
+
+    for (int m = 0; m < numInterpolationModes; ++m)
+    {
+        const auto [ticks, numSamples] = mSampler.getRenderCost(static_cast<InterpolationMode>(m));
+
+        if (numSamples > 0)
+            report.interpolationNanosecondsPerSample[(size_t)m] = juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9 / (double)numSamples;
+    }
+
+    return report;
+}
+
+void WalsheeySampleAudioProcessor::setResampleToHostRate(bool shouldResample)
+{
+    mResampleToHostRate = shouldResample;
+    updateTargetSampleRate();
+}
+
+void WalsheeySampleAudioProcessor::updateTargetSampleRate()
+{
+    const double target = mResampleToHostRate ? mHostSampleRate.load() : 0.0;
+
+    if (target == mLoader.getTargetSampleRate())
+        return;
+
+    mLoader.setTargetSampleRate(target);
+
+    // The current sounds keep playing, at a fractional ratio, until their
+    // replacements are ready.
+    for (int id = 0; id < SamplerSynthesiser::maxPads; ++id)
+    {
+        const auto& pad = mPadFiles[(size_t)id];
+
+        if (mPadSounds[(size_t)id] == nullptr || pad.zones.empty())
+            continue;
+
+        // Streamed sounds are never resampled, so they would come back
+        // unchanged.
+        const auto& sound = *mPadSounds[(size_t)id];
+        bool isStreamed = true;
+
+        for (int i = 0; i < sound.getNumZones(); ++i)
+            isStreamed = isStreamed && sound.getZone(i).streamSource != nullptr;
+
+        if (isStreamed)
+            continue;
+
+        mKeepPadSettings[(size_t)id] = true;
+        mLoader.load(pad.zones, pad.midiNote, id);
+    }
+}
+
+void WalsheeySampleAudioProcessor::timerCallback()
+{
+    updateModelFromParameters();
+
+    if (mStateChanged)
+        updateStateSnapshot();
+
+    // The rest only needs to run about twice a second.
+    if (++mTimerTicks % 15 != 0)
+        return;
+
+    updateTargetSampleRate();
+
+    mCommands.collectGarbage();
+    mReleasePool.collectGarbage();
+    mSampler.getStreamer().releaseUnusedSources();
+
+    // Samples whose last sound was just freed, in this or any other instance.
+    mLoader.getSamplePool().collectGarbage();
+}
+
+void WalsheeySampleAudioProcessor::setADSR(ADSRParameters adsr, int id)
+{
+    setParameter(id, "Attack", adsr.attack);
+    setParameter(id, "Decay", adsr.decay);
+    setParameter(id, "Sustain", adsr.sustain);
+    setParameter(id, "Release", adsr.release);
+}
+
+void WalsheeySampleAudioProcessor::setEnvelopeCurve(EnvelopeCurve curve, int id)
+{
+    setParameter(id, "Curve", (float)static_cast<int>(curve));
 }
 
 void WalsheeySampleAudioProcessor::setPitchShift(int semitones, int id)
 {
-    class SetPitchShiftCommand
+    setParameter(id, "Pitch", (float)semitones);
+}
+
+void WalsheeySampleAudioProcessor::setGain(float decibels, int id)
+{
+    setParameter(id, "Gain", decibels);
+}
+
+juce::String WalsheeySampleAudioProcessor::getParameterID(int pad, const juce::String& name)
+{
+    return "pad" + juce::String(pad + 1) + name;
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout WalsheeySampleAudioProcessor::createParameterLayout()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    const juce::NormalisableRange<float> timeRange(0.0f, 5.0f, 0.001f, 0.4f);
+    const juce::NormalisableRange<float> gainRange(SampleModel::minGainDecibels, SampleModel::maxGainDecibels, 0.1f);
+    const ADSRParameters defaultADSR;
+
+    juce::NormalisableRange<float> cutoffRange(20.0f, 20000.0f, 0.1f);
+    cutoffRange.setSkewForCentre(1000.0f);
+    juce::NormalisableRange<float> resonanceRange(0.1f, 20.0f);
+    resonanceRange.setSkewForCentre(1.0f);
+    const juce::NormalisableRange<float> octaveRange(-8.0f, 8.0f, 0.01f);
+    const juce::StringArray curves { "Linear", "Exponential" };
+    const juce::StringArray filterModes { "Off", "Lowpass", "Bandpass", "Highpass" };
+    const FilterParameters defaultFilter;
+
+    for (int pad = 0; pad < numPads; ++pad)
+    {
+        const auto name = "Pad " + juce::String(pad + 1) + " ";
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { getParameterID(pad, "Attack"), 1 }, name + "Attack", timeRange, defaultADSR.attack),
+                   std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { getParameterID(pad, "Decay"), 1 }, name + "Decay", timeRange, defaultADSR.decay),
+                   std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { getParameterID(pad, "Sustain"), 1 }, name + "Sustain", 0.0f, 1.0f, defaultADSR.sustain),
+                   std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { getParameterID(pad, "Release"), 1 }, name + "Release", timeRange, defaultADSR.release),
+                   std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { getParameterID(pad, "Curve"), 1 }, name + "Curve", curves, static_cast<int>(EnvelopeCurve::linear)),
+                   std::make_unique<juce::AudioParameterInt>(juce::ParameterID { getParameterID(pad, "Pitch"), 1 }, name + "Pitch", -12, 12, 0),
+                   std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { getParameterID(pad, "Gain"), 1 }, name + "Gain", gainRange, 0.0f),
+                   std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { getParameterID(pad, "FilterMode"), 1 }, name + "Filter Mode", filterModes, static_cast<int>(defaultFilter.mode)),
+                   std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { getParameterID(pad, "Cutoff"), 1 }, name + "Cutoff", cutoffRange, defaultFilter.cutoff),
+                   std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { getParameterID(pad, "Resonance"), 1 }, name + "Resonance", resonanceRange, defaultFilter.resonance),
+                   std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { getParameterID(pad, "FilterEnvelope"), 1 }, name + "Filter Envelope", octaveRange, defaultFilter.envelopeAmount),
+                   std::make_unique<juce::AudioParameterFloat>(juce::ParameterID { getParameterID(pad, "FilterVelocity"), 1 }, name + "Filter Velocity", octaveRange, defaultFilter.velocityAmount));
+    }
+
+    return layout;
+}
+
+void WalsheeySampleAudioProcessor::setParameter(int pad, const juce::String& name, float value)
+{
+    auto* parameter = mParameters.getParameter(getParameterID(pad, name));
+
+    if (parameter == nullptr)
+        return;
+
+    // Values that come back from the model unchanged are not sent on to the
+    // host again.
+    const float normalised = parameter->convertTo0to1(value);
+
+    if (std::abs(parameter->getValue() - normalised) <= 1.0e-6f)
+        return;
+
+    // The host reads every parameter again once a restore is done, and must
+    // not record the restore as an edit.
+    if (mIsRestoring)
+    {
+        parameter->setValue(normalised);
+        return;
+    }
+
+    // Each edit from the editor is a gesture of its own, so hosts that only
+    // record automation inside one still see it.
+    parameter->beginChangeGesture();
+    parameter->setValueNotifyingHost(normalised);
+    parameter->endChangeGesture();
+}
+
+void WalsheeySampleAudioProcessor::applyParameters() noexcept
+{
+    // Plain loads of the parameters' atomics; a sounding voice picks up the
+    // new pitch and gain at its next block, and a new envelope at its next
+    // note.
+    for (int pad = 0; pad < numPads; ++pad)
+    {
+        auto* sound = mSampler.getPadSound(pad);
+
+        if (sound == nullptr)
+            continue;
+
+        const auto& parameters = mPadParameters[(size_t)pad];
+
+        sound->setEnvelopeParameters({ parameters.attack->get(),
+                                       parameters.decay->get(),
+                                       parameters.sustain->get(),
+                                       parameters.release->get() });
+        sound->setEnvelopeCurve(toBlockCurve(static_cast<EnvelopeCurve>(parameters.curve->getIndex())));
+        sound->setPitchShift(parameters.pitch->get());
+        sound->setGain(juce::Decibels::decibelsToGain(parameters.gain->get(), SampleModel::minGainDecibels));
+        sound->setFilterParameters(parameters.getFilter());
+    }
+}
+
+FilterParameters WalsheeySampleAudioProcessor::PadParameters::getFilter() const noexcept
+{
+    FilterParameters result;
+    result.mode = static_cast<FilterMode>(filterMode->getIndex());
+    result.cutoff = cutoff->get();
+    result.resonance = resonance->get();
+    result.envelopeAmount = filterEnvelope->get();
+    result.velocityAmount = filterVelocity->get();
+    return result;
+}
+
+void WalsheeySampleAudioProcessor::updateModelFromParameters()
+{
+    for (int pad = 0; pad < numPads; ++pad)
+    {
+        auto sampleTree = mDataModel.getSampleTree(pad);
+
+        if (!sampleTree.isValid())
+            continue;
+
+        const auto& parameters = mPadParameters[(size_t)pad];
+        const ADSRParameters adsr(parameters.attack->get(), parameters.decay->get(), parameters.sustain->get(), parameters.release->get());
+        const auto curve = static_cast<EnvelopeCurve>(parameters.curve->getIndex());
+        const int pitch = parameters.pitch->get();
+        const float gain = parameters.gain->get();
+        const auto filter = parameters.getFilter();
+
+        if (adsr == getSampleProperty<ADSRParameters>(sampleTree, IDs::adsr)
+            && curve == getEnvelopeCurveProperty(sampleTree)
+            && pitch == static_cast<int>(sampleTree[IDs::pitchShift])
+            && std::abs(gain - static_cast<float>(sampleTree.getProperty(IDs::gain, 0.0f))) < 0.01f
+            && filter == getSampleProperty<FilterParameters>(sampleTree, IDs::filter))
+            continue;
+
+        SampleModel sample(sampleTree);
+        sample.setADSR(adsr);
+        sample.setEnvelopeCurve(curve);
+        sample.setPitchShift(pitch);
+        sample.setGain(gain);
+        sample.setFilter(filter);
+    }
+}
+
+void WalsheeySampleAudioProcessor::setInterpolationMode(InterpolationMode mode, int id)
+{
+    class SetInterpolationCommand
     {
     public:
-        SetPitchShiftCommand(int semitones, int identifier)
-            :pitchShiftSemitones(semitones), id(identifier)
+        SetInterpolationCommand(InterpolationMode m, int identifier)
+            :mode(m), id(identifier)
         {
         }
 
         void operator() (WalsheeySampleAudioProcessor& proc)
         {
-            for (int i = 0; i < proc.mSampler.getNumSounds(); ++i)
-            {
-                ExtendedSamplerSound* samplerSound = dynamic_cast<ExtendedSamplerSound*>(proc.mSampler.getSound(i).get());
-
-                if (samplerSound != nullptr)
-                {
-                    if (samplerSound->getName() == juce::String(id))
-                    {
-                        samplerSound->setPitchShift(pitchShiftSemitones);
-                        break;
-                    }
-                }
-            }
+            if (auto* samplerSound = proc.mSampler.getPadSound(id))
+                samplerSound->setInterpolationMode(mode);
         }
 
-        int pitchShiftSemitones; 
+        InterpolationMode mode; 
         int id;
     };
 
-    mCommands.push(SetPitchShiftCommand(semitones, id));
+    mCommands.push(SetInterpolationCommand(mode, id), commandKey(interpolationCommand, id));
+}
+
+void WalsheeySampleAudioProcessor::setFilter(FilterParameters filter, int id)
+{
+    setParameter(id, "FilterMode", (float)static_cast<int>(filter.mode));
+    setParameter(id, "Cutoff", filter.cutoff);
+    setParameter(id, "Resonance", filter.resonance);
+    setParameter(id, "FilterEnvelope", filter.envelopeAmount);
+    setParameter(id, "FilterVelocity", filter.velocityAmount);
+}
+
+void WalsheeySampleAudioProcessor::setNumVoices(int numVoices)
+{
+    // The pool is resized on the next prepareToPlay so voices are never
+    // allocated while the audio thread is rendering.
+    mRequestedNumVoices = juce::jlimit(SamplerSynthesiser::minNumVoices, SamplerSynthesiser::maxNumVoices, numVoices);
+}
+
+void WalsheeySampleAudioProcessor::setNumRenderThreads(int numThreads)
+{
+    mRequestedRenderThreads = juce::jlimit(0, VoiceRenderPool::maxThreads, numThreads);
+
+    // Unlike the voice pool, the threads can change while playing: hosts
+    // hold the callback lock around processBlock, so this waits for the
+    // current block and the next one sees the new threads.
+    if (getSampleRate() > 0)
+    {
+        const juce::ScopedLock sl(getCallbackLock());
+        mSampler.setNumRenderThreads(mRequestedRenderThreads.load());
+        mSampler.prepareRenderThreads(getTotalNumOutputChannels(), getBlockSize());
+    }
+}
+
+void WalsheeySampleAudioProcessor::setStreamingOptions(const StreamingOptions& options)
+{
+    // Threshold and preload apply to the next loads; the ring buffers are
+    // resized on the next prepareToPlay.
+    mLoader.setStreamingOptions(options);
+    mRequestedReadAhead = options.readAheadFrames;
 }
 
 void WalsheeySampleAudioProcessor::process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    const juce::GenericScopedTryLock<juce::SpinLock> lock(mCommandQueueMutex);
+    mCommands.call(*this);
+    applyParameters();
 
-    if (lock.isLocked())
-        mCommands.call(*this);
+    // With no voice sounding and no MIDI to start one, the synth would only
+    // add silence to outputs processBlock has already cleared, so it and the
+    // per-voice bookkeeping are skipped. An empty snapshot is published once
+    // on entering the idle state.
+    if (midiMessages.isEmpty() && mSampler.getNumActiveVoices() == 0)
+    {
+        if (!mIsIdle)
+        {
+            publishPlayheads();
+            mIsIdle = true;
+        }
+
+        return;
+    }
+
+    mIsIdle = false;
 
     mSampler.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples()); 
 
-    ExtendedSamplerVoice* voice = dynamic_cast<ExtendedSamplerVoice*>(mSampler.getVoice(0));
-    if (voice != nullptr)
+    publishPlayheads();
+}
+
+PerformanceMonitor::Report WalsheeySampleAudioProcessor::getPerformanceReport()
+{
+    auto report = mPerformance.getReport();
+    report.numFailedCommandPushes = getNumFailedCommandPushes();
+    report.loaderBacklog = mLoader.getNumPendingJobs();
+    report.numStreamUnderruns = getNumStreamUnderruns();
+    return report;
+}
+
+void WalsheeySampleAudioProcessor::publishPlayheads() noexcept
+{
+    auto& snapshot = mPlayheads.getWriteBuffer();
+    snapshot.numVoices = 0;
+    snapshot.timeNs = 0;
+
+    if (auto* playHead = getPlayHead())
+        if (auto position = playHead->getPosition())
+            if (auto hostTime = position->getHostTimeNs())
+                snapshot.timeNs = *hostTime;
+
+    if (snapshot.timeNs == 0)
+        snapshot.timeNs = (juce::uint64)(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks()) * 1.0e9);
+
+    for (int i = 0; i < mSampler.getNumVoices(); ++i)
     {
-        playbackPosition = static_cast<float>(voice->getSourceSamplePosition() / voice->getSampleRate());
-        mCurrentMidiNode = voice->getCurrentlyPlayingNote(); 
+        auto* voice = static_cast<ExtendedSamplerVoice*>(mSampler.getVoice(i));
+
+        if (!voice->isVoiceActive())
+            continue;
+
+        auto& playhead = snapshot.voices[(size_t)snapshot.numVoices++];
+        playhead.padId = voice->getPadId();
+        playhead.midiNote = voice->getCurrentlyPlayingNote();
+        playhead.position = static_cast<float>(voice->getPositionSeconds());
+        playhead.envelopeLevel = voice->getEnvelopeLevel();
     }
-}
 
-    
\ No newline at end of file
+    mPlayheads.publish();
+}
@@ -12,6 +12,12 @@
 #include "Command.h"
 #include "Model.h"
 #include "Sampler.h"
+#include "SampleLoader.h"
+#include "ReleasePool.h"
+#include "PluginState.h"
+#include "SampleEncoder.h"
+#include "TripleBuffer.h"
+#include "PerformanceMonitor.h"
 
 //==============================================================================
 /**
@@ -21,6 +27,10 @@ class WalsheeySampleAudioProcessor  : public juce::AudioProcessor
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
+                             , private juce::Timer
+                             , private juce::AsyncUpdater
+                             , private juce::ValueTree::Listener
+                             , private SampleLoader::Listener
 {
 public:
     //==============================================================================
@@ -62,20 +72,175 @@ public:
 
     void process(juce::AudioBuffer<float>&, juce::MidiBuffer&);
 
-    void setSample(std::unique_ptr<juce::AudioFormatReader>, int, int);
-    void setADSR(ADSRParameters, int); 
-    void setPitchShift(int, int); 
+    // The pads' model, shared by the editor's views. Changes to it are
+    // applied to the sampler whether or not an editor is open.
+    const DataModel& getDataModel() const { return mDataModel; }
+
+    static constexpr int numPads = 8;
 
+    // Each pad's envelope, pitch and gain, as host-automatable parameters.
+    juce::AudioProcessorValueTreeState& getParameters() noexcept { return mParameters; }
 
-    PlaybackData getPlaybackPosition() { return { playbackPosition.get(), mCurrentMidiNode.get() }; }
+    void setSample(const juce::File&, int, int);
+    // Loads a pad with velocity layers and round-robin zones. The pad plays
+    // as soon as the first zone's layer has loaded.
+    void setSampleZones(const std::vector<SampleZone>&, int, int);
+    // The envelope, pitch and gain are host parameters; these set them as
+    // if the user had.
+    void setADSR(ADSRParameters, int); 
+    void setEnvelopeCurve(EnvelopeCurve, int);
+    void setPitchShift(int, int); 
+    void setGain(float decibels, int);
+    void setInterpolationMode(InterpolationMode, int); 
+    void setSampleRegion(const SampleRegion&, int);
+    void setFilter(FilterParameters, int);
+    void setNumVoices(int); 
+    // Worker threads that help render busy blocks, from a pool shared by
+    // every instance. Follows the model's render threads setting.
+    void setNumRenderThreads(int);
+    void setStreamingOptions(const StreamingOptions&);
+    void setMemoryMappingEnabled(bool shouldMap) { mLoader.setMemoryMappingEnabled(shouldMap); }
+    void setCompactStorageEnabled(bool shouldCompact) { mLoader.setCompactStorageEnabled(shouldCompact); }
+    // Resamples in-memory samples to the host rate as they load, and reloads
+    // every pad when the host rate changes.
+    void setResampleToHostRate(bool);
+    // Saves the pads' audio, FLAC encoded, in the plugin state so a project
+    // opens without its sample files. Files are encoded in the background;
+    // a state saved before a file has been encoded refers to it by path.
+    // Also set from the Settings tab, through the model.
+    void setEmbedSamples(bool);
+    bool getEmbedSamples() const noexcept { return mEmbedSamples; }
+
+    void addLoadListener(SampleLoader::Listener& listener) { mLoader.addListener(listener); }
+    void removeLoadListener(SampleLoader::Listener& listener) { mLoader.removeListener(listener); }
+
+
+    // Message thread only. Every sounding voice as of the last block.
+    const PlaybackSnapshot& getPlaybackSnapshot() noexcept { return mPlayheads.read(); }
+
+    int getNumFailedCommandPushes() const noexcept { return mCommands.getNumFailedPushes(); }
+    int getNumStreamUnderruns() { return mSampler.getStreamer().getNumUnderruns(); }
+
+    // Any thread but the audio thread, e.g. a test harness polling while it
+    // plays. Timing, voice and queue statistics since the last reset, with
+    // the loader backlog and the counters above.
+    // PerformanceMonitor::getAllReports covers every instance in the process.
+    PerformanceMonitor::Report getPerformanceReport();
+    void resetPerformanceStats() noexcept { mPerformance.reset(); }
+    void setOverrunThreshold(float threshold) noexcept { mPerformance.setOverrunThreshold(threshold); }
+
+    // Message thread only. Covers the sound currently assigned to each pad.
+    StorageReport getStorageReport() const;
 
 private:
-    juce::Synthesiser mSampler; 
+    // Per-pad commands of the same type coalesce in the command queue.
+    enum CommandType
+    {
+        sampleCommand = 0,
+        interpolationCommand
+    };
+
+    // The audio thread's view of a pad's parameters. These read each
+    // parameter's own value rather than the tree state's raw atomics, which
+    // only follow changes the host is told about: a restore sets the values
+    // without telling the host.
+    struct PadParameters
+    {
+        juce::AudioParameterFloat* attack = nullptr;
+        juce::AudioParameterFloat* decay = nullptr;
+        juce::AudioParameterFloat* sustain = nullptr;
+        juce::AudioParameterFloat* release = nullptr;
+        juce::AudioParameterChoice* curve = nullptr;
+        juce::AudioParameterInt* pitch = nullptr;
+        juce::AudioParameterFloat* gain = nullptr;
+        juce::AudioParameterChoice* filterMode = nullptr;
+        juce::AudioParameterFloat* cutoff = nullptr;
+        juce::AudioParameterFloat* resonance = nullptr;
+        juce::AudioParameterFloat* filterEnvelope = nullptr;
+        juce::AudioParameterFloat* filterVelocity = nullptr;
+
+        FilterParameters getFilter() const noexcept;
+    };
+
+    static juce::String getParameterID(int pad, const juce::String& name);
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    void setParameter(int pad, const juce::String& name, float value);
+    // Audio thread. Once per block.
+    void applyParameters() noexcept;
+    // Audio thread. Once per block.
+    void publishPlayheads() noexcept;
+    // Message thread. Copies parameters changed by the host into the model.
+    void updateModelFromParameters();
+
+    static int commandKey(CommandType type, int id) { return CommandFifo<WalsheeySampleAudioProcessor>::makeKey(type, id); }
+
+    struct PadFile
+    {
+        std::vector<SampleZone> zones;
+        int midiNote = -1;
+    };
+
+    void setSound(ExtendedSamplerSound::Ptr, bool keepSettings);
+    void clearPad(int id);
+    void applyModelSettings(ExtendedSamplerSound&) const;
+    void updateTargetSampleRate();
+    void timerCallback() override;
+
+    // Restores the state chunk saved by setStateInformation.
+    void handleAsyncUpdate() override;
+    KitState makeState();
+    void updateStateSnapshot();
+    void embedSamplesChanged(bool shouldEmbed);
+    void requestEncoding(int id);
+    void updateEncodedFiles();
+
+    void valueTreePropertyChanged(juce::ValueTree&, const juce::Identifier&) override;
+    void sampleLoadFinished(const SampleLoader::Result&) override;
+
+    DataModel mDataModel;
+
+    SamplerSynthesiser mSampler; 
+    SampleLoader mLoader; 
+    ReleasePool<juce::SynthesiserSound> mReleasePool; 
+    // Message thread's view of the current sound per pad.
+    std::array<ExtendedSamplerSound::Ptr, SamplerSynthesiser::maxPads> mPadSounds;
+    std::array<PadFile, SamplerSynthesiser::maxPads> mPadFiles;
+    std::array<SampleRegion, SamplerSynthesiser::maxPads> mPadRegions;
+    // Pads whose next sound keeps the current one's settings: those being
+    // reloaded at a new rate, or receiving more zones of the same load.
+    std::array<bool, SamplerSynthesiser::maxPads> mKeepPadSettings {};
+    bool mResampleToHostRate = false;
+    std::atomic<bool> mEmbedSamples { false };
+    SampleEncoder mEncoder;
+    std::atomic<double> mHostSampleRate { 0.0 };
+    std::atomic<int> mRequestedNumVoices { SamplerSynthesiser::defaultNumVoices }; 
+    std::atomic<int> mRequestedRenderThreads { 0 };
+    std::atomic<int> mRequestedReadAhead { StreamingOptions().readAheadFrames };
+    // Pushed from the message thread only, drained at the start of process().
     CommandFifo<WalsheeySampleAudioProcessor> mCommands; 
-    juce::SpinLock mCommandQueueMutex;
 
-    juce::Atomic<float> playbackPosition; 
-    juce::Atomic<float> mCurrentMidiNode; 
+    PerformanceMonitor mPerformance;
+    TripleBuffer<PlaybackSnapshot> mPlayheads;
+    static_assert(PlaybackSnapshot::maxVoices >= SamplerSynthesiser::maxNumVoices, "Every voice needs room in the snapshot");
+
+    juce::AudioProcessorValueTreeState mParameters;
+    std::array<PadParameters, numPads> mPadParameters;
+    int mTimerTicks = 0;
+    // Audio thread only.
+    bool mIsIdle = false;
+
+    // The chunk given to setStateInformation, until it has been restored.
+    juce::MemoryBlock mPendingState;
+    juce::CriticalSection mPendingStateLock;
+    // Set while a restore writes the model, so its file changes do not
+    // start loads of their own.
+    bool mIsRestoring = false;
+
+    // What getStateInformation saves when called off the message thread.
+    // Rebuilt by the timer after the model or the pads' files change.
+    KitState mStateSnapshot;
+    juce::CriticalSection mStateLock;
+    bool mStateChanged = true;    // Message thread only
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WalsheeySampleAudioProcessor)
 };
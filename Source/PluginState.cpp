@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+    PluginState.cpp
+    Created: 18 Oct 2026 12:04:37am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "PluginState.h"
+#include <map>
+
+namespace
+{
+    constexpr int magic = 0x504d5357;    // "WSMP"
+    // 2: samples may be embedded.
+    // 3: the number of render threads.
+    constexpr int currentVersion = 3;
+
+    // Guards against reading garbage as an enormous count.
+    constexpr int maxPads = 1024;
+    constexpr int maxZonesPerPad = 1024;
+
+    void writePad(const PadState& pad, juce::OutputStream& out)
+    {
+        out.writeInt(pad.id);
+        out.writeString(pad.name);
+        out.writeInt(pad.midiNote);
+
+        out.writeFloat(pad.adsr.attack);
+        out.writeFloat(pad.adsr.decay);
+        out.writeFloat(pad.adsr.sustain);
+        out.writeFloat(pad.adsr.release);
+
+        out.writeInt(pad.pitchShift);
+        out.writeInt(static_cast<int>(pad.interpolation));
+
+        out.writeDouble(pad.region.start);
+        out.writeDouble(pad.region.end);
+        out.writeDouble(pad.region.loopStart);
+        out.writeDouble(pad.region.loopEnd);
+        out.writeDouble(pad.region.crossfade);
+        out.writeBool(pad.region.isLooping);
+
+        out.writeInt(static_cast<int>(pad.filter.mode));
+        out.writeFloat(pad.filter.cutoff);
+        out.writeFloat(pad.filter.resonance);
+        out.writeFloat(pad.filter.envelopeAmount);
+        out.writeFloat(pad.filter.velocityAmount);
+
+        out.writeDouble(pad.lengthSeconds);
+        out.writeInt((int)pad.zones.size());
+
+        for (const auto& zone : pad.zones)
+        {
+            out.writeString(zone.file.getFullPathName());
+            out.writeInt(zone.lowVelocity);
+            out.writeInt(zone.highVelocity);
+            out.writeInt64(zone.identity.modificationTime);
+            out.writeInt64(zone.identity.size);
+            out.writeInt64(static_cast<juce::int64>(zone.identity.contentHash));
+        }
+
+        // Fields added since version 1 go here, at the end of the block.
+        out.writeFloat(pad.gain);
+        out.writeInt(static_cast<int>(pad.envelopeCurve));
+    }
+
+    PadState readPad(juce::InputStream& in)
+    {
+        PadState pad;
+        pad.id = in.readInt();
+        pad.name = in.readString();
+        pad.midiNote = in.readInt();
+
+        pad.adsr.attack = in.readFloat();
+        pad.adsr.decay = in.readFloat();
+        pad.adsr.sustain = in.readFloat();
+        pad.adsr.release = in.readFloat();
+
+        pad.pitchShift = in.readInt();
+        pad.interpolation = static_cast<InterpolationMode>(juce::jlimit(0, 2, in.readInt()));
+
+        pad.region.start = in.readDouble();
+        pad.region.end = in.readDouble();
+        pad.region.loopStart = in.readDouble();
+        pad.region.loopEnd = in.readDouble();
+        pad.region.crossfade = in.readDouble();
+        pad.region.isLooping = in.readBool();
+
+        pad.filter.mode = static_cast<FilterMode>(juce::jlimit(0, 3, in.readInt()));
+        pad.filter.cutoff = in.readFloat();
+        pad.filter.resonance = in.readFloat();
+        pad.filter.envelopeAmount = in.readFloat();
+        pad.filter.velocityAmount = in.readFloat();
+
+        pad.lengthSeconds = in.readDouble();
+
+        const int numZones = in.readInt();
+
+        if (!juce::isPositiveAndNotGreaterThan(numZones, maxZonesPerPad))
+            return pad;
+
+        for (int z = 0; z < numZones; ++z)
+        {
+            PadState::Zone zone;
+            const auto path = in.readString();
+            zone.lowVelocity = in.readInt();
+            zone.highVelocity = in.readInt();
+            zone.identity.modificationTime = in.readInt64();
+            zone.identity.size = in.readInt64();
+            zone.identity.contentHash = static_cast<juce::uint64>(in.readInt64());
+
+            // A path saved on another system may not be absolute here.
+            if (juce::File::isAbsolutePath(path))
+            {
+                zone.file = juce::File(path);
+                pad.zones.push_back(zone);
+            }
+        }
+
+        if (!in.isExhausted())
+            pad.gain = in.readFloat();
+
+        if (!in.isExhausted())
+            pad.envelopeCurve = static_cast<EnvelopeCurve>(juce::jlimit(0, 1, in.readInt()));
+
+        return pad;
+    }
+}
+
+void PluginState::write(const KitState& kit, juce::OutputStream& out)
+{
+    out.writeInt(magic);
+    out.writeInt(currentVersion);
+    out.writeBool(kit.embedSamples);
+    out.writeInt(kit.numRenderThreads);
+    out.writeInt((int)kit.pads.size());
+
+    std::map<juce::uint64, std::shared_ptr<const juce::MemoryBlock>> embedded;
+
+    for (const auto& pad : kit.pads)
+    {
+        // Each pad is prefixed with its size, so a reader can tell a
+        // truncated pad from a complete one and skip fields it does not know.
+        juce::MemoryOutputStream padOut;
+        writePad(pad, padOut);
+
+        out.writeInt((int)padOut.getDataSize());
+        out.write(padOut.getData(), padOut.getDataSize());
+
+        for (const auto& zone : pad.zones)
+            if (zone.embeddedAudio != nullptr && zone.identity.isHashed())
+                embedded[zone.identity.contentHash] = zone.embeddedAudio;
+    }
+
+    // Zones find their audio by content hash.
+    out.writeInt((int)embedded.size());
+
+    for (const auto& entry : embedded)
+    {
+        out.writeInt64(static_cast<juce::int64>(entry.first));
+        out.writeInt64((juce::int64)entry.second->getSize());
+        out.write(entry.second->getData(), entry.second->getSize());
+    }
+}
+
+bool PluginState::read(const void* data, size_t numBytes, KitState& kit)
+{
+    kit = {};
+
+    juce::MemoryInputStream in(data, numBytes, false);
+
+    if (in.readInt() != magic)
+        return false;
+
+    const int version = in.readInt();
+
+    if (!juce::isPositiveAndNotGreaterThan(version, currentVersion))
+        return false;
+
+    if (version >= 2)
+        kit.embedSamples = in.readBool();
+
+    if (version >= 3)
+        kit.numRenderThreads = in.readInt();
+
+    const int numPads = in.readInt();
+
+    if (!juce::isPositiveAndNotGreaterThan(numPads, maxPads))
+        return false;
+
+    for (int p = 0; p < numPads; ++p)
+    {
+        const int padSize = in.readInt();
+
+        if (padSize <= 0 || padSize > in.getNumBytesRemaining())
+            return true;
+
+        juce::MemoryInputStream padIn(static_cast<const char*> (data) + in.getPosition(), (size_t)padSize, false);
+        in.skipNextBytes(padSize);
+
+        kit.pads.push_back(readPad(padIn));
+    }
+
+    if (version < 2)
+        return true;
+
+    const int numEmbedded = in.readInt();
+
+    for (int e = 0; e < numEmbedded; ++e)
+    {
+        const auto hash = static_cast<juce::uint64>(in.readInt64());
+        const auto size = in.readInt64();
+
+        if (size <= 0 || size > in.getNumBytesRemaining())
+            break;
+
+        auto audio = std::make_shared<const juce::MemoryBlock>(static_cast<const char*> (data) + in.getPosition(), (size_t)size);
+        in.skipNextBytes(size);
+
+        for (auto& pad : kit.pads)
+            for (auto& zone : pad.zones)
+                if (zone.identity.contentHash == hash)
+                    zone.embeddedAudio = audio;
+    }
+
+    return true;
+}
@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    PluginState.h
+    Created: 18 Oct 2026 12:04:37am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "Model.h"
+#include "SamplePool.h"
+
+//=====================================================================
+// Everything saved for one pad: its SampleModel parameters and the files
+// it plays, with the identity each file had when it was saved.
+struct PadState
+{
+    struct Zone
+    {
+        juce::File file;
+        int lowVelocity = 1;
+        int highVelocity = 127;
+        FileIdentity identity;
+        // FLAC data of the file, when samples are embedded.
+        std::shared_ptr<const juce::MemoryBlock> embeddedAudio;
+    };
+
+    int id = -1;
+    juce::String name;
+    int midiNote = 0;
+    ADSRParameters adsr;
+    EnvelopeCurve envelopeCurve = EnvelopeCurve::linear;
+    int pitchShift = 0;
+    float gain = 0.0f;    // Decibels
+    InterpolationMode interpolation = InterpolationMode::linear;
+    SampleRegion region;
+    FilterParameters filter;
+    double lengthSeconds = 0.0;    // So the editor can show the pad before it has loaded
+    std::vector<Zone> zones;
+};
+
+//=====================================================================
+struct KitState
+{
+    bool embedSamples = false;
+    int numRenderThreads = 0;
+    std::vector<PadState> pads;
+};
+
+//=====================================================================
+// The plugin's state chunk: a small versioned binary format holding a
+// PadState per pad. Normally it stores references to the sample files, so
+// reading it costs next to nothing however large the kit is. With samples
+// embedded, their FLAC data follows the pads, once per distinct content
+// hash however many zones share it.
+namespace PluginState
+{
+    void write(const KitState&, juce::OutputStream&);
+
+    // Returns false, leaving kit empty, if data is not a chunk this version
+    // can read.
+    bool read(const void* data, size_t numBytes, KitState& kit);
+}
@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+    RegionView.cpp
+    Created: 18 Oct 2026 5:02:14am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "RegionView.h"
+
+RegionView::RegionView(const DataModel& dm)
+    :mDataModel(dm)
+{
+    mDataModel.addListener(*this);
+
+    auto initSlider = [this](juce::Slider& slider, juce::Label& label, const juce::String& text)
+    {
+        label.setText(text, juce::dontSendNotification);
+        label.setJustificationType(juce::Justification::centred);
+        addAndMakeVisible(label);
+
+        slider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
+        slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 15);
+        slider.setTextValueSuffix(" s");
+        slider.setRange(juce::Range<double>(0, 1), 0.001);
+        slider.addListener(this);
+        addAndMakeVisible(slider);
+    };
+
+    initSlider(mStartSlider, mStartLabel, "Start");
+    initSlider(mEndSlider, mEndLabel, "End");
+    initSlider(mLoopStartSlider, mLoopStartLabel, "Loop Start");
+    initSlider(mLoopEndSlider, mLoopEndLabel, "Loop End");
+    initSlider(mCrossfadeSlider, mCrossfadeLabel, "Crossfade");
+    mCrossfadeSlider.setSkewFactorFromMidPoint(0.1);
+
+    mLoopButton.onClick = [this] { loopToggled(); };
+    addAndMakeVisible(mLoopButton);
+
+    updateRanges();
+    updateControls({});
+}
+
+RegionView::~RegionView()
+{
+    mDataModel.removeListener(*this);
+
+    if (mActiveSample != nullptr)
+        mActiveSample->removeListener(*this);
+}
+
+void RegionView::paint(juce::Graphics& g)
+{
+    g.setColour(getLookAndFeel().findColour(AppColors::ColourIds::BackgroundDefault));
+    g.fillAll();
+
+    g.setColour(getLookAndFeel().findColour(AppColors::ColourIds::Divider));
+    auto bounds = getLocalBounds();
+    bounds.removeFromTop(spacing::padding3);
+    bounds.removeFromLeft(spacing::padding3);
+    bounds.removeFromRight(spacing::padding3);
+    g.fillRoundedRectangle(bounds.toFloat(), spacing::padding4);
+}
+
+void RegionView::resized()
+{
+    juce::Grid grid;
+
+    using Track = juce::Grid::TrackInfo;
+    using Fr = juce::Grid::Fr;
+
+    grid.templateRows = { Track(Fr(3)), Track(Fr(1)), Track(Fr(3)), Track(Fr(1)) };
+    grid.templateColumns = { Track(Fr(1)), Track(Fr(1)), Track(Fr(1)), Track(Fr(1)) };
+    grid.items = { juce::GridItem(mStartSlider).withArea(1,1),
+                   juce::GridItem(mStartLabel).withArea(2,1),
+                   juce::GridItem(mEndSlider).withArea(1,2),
+                   juce::GridItem(mEndLabel).withArea(2,2),
+                   juce::GridItem(mLoopButton).withArea(1,4).withHeight(24).withAlignSelf(juce::GridItem::AlignSelf::center)
+                                              .withMargin(juce::GridItem::Margin(0, spacing::padding3, 0, spacing::padding3)),
+                   juce::GridItem(mLoopStartSlider).withArea(3,1),
+                   juce::GridItem(mLoopStartLabel).withArea(4,1),
+                   juce::GridItem(mLoopEndSlider).withArea(3,2),
+                   juce::GridItem(mLoopEndLabel).withArea(4,2),
+                   juce::GridItem(mCrossfadeSlider).withArea(3,3),
+                   juce::GridItem(mCrossfadeLabel).withArea(4,3)
+    };
+
+    grid.performLayout(getLocalBounds().reduced(spacing::padding3));
+}
+
+void RegionView::activeSampleChanged(SampleModel& sm)
+{
+    if (mActiveSample != nullptr)
+        mActiveSample->removeListener(*this);
+
+    mActiveSample = std::make_unique<SampleModel>(sm.getState());
+    mActiveSample->addListener(*this);
+
+    updateRanges();
+    updateControls(mActiveSample->getRegion());
+}
+
+void RegionView::regionChanged(SampleRegion region)
+{
+    updateControls(region);
+}
+
+void RegionView::totalRangeChanged(juce::Range<double>)
+{
+    updateRanges();
+
+    if (mActiveSample != nullptr)
+        updateControls(mActiveSample->getRegion());
+}
+
+void RegionView::sliderValueChanged(juce::Slider* sliderChanged)
+{
+    if (mActiveSample == nullptr)
+        return;
+
+    auto region = mActiveSample->getRegion();
+    const double value = sliderChanged->getValue();
+
+    if (sliderChanged == &mStartSlider)
+        region.start = value;
+    else if (sliderChanged == &mEndSlider)
+        // The end of the sample is stored as 0, so the region still reaches
+        // the end if the sample is replaced by a longer one.
+        region.end = value >= mEndSlider.getMaximum() ? 0.0 : value;
+    else if (sliderChanged == &mLoopStartSlider)
+        region.loopStart = value;
+    else if (sliderChanged == &mLoopEndSlider)
+        region.loopEnd = value;
+    else if (sliderChanged == &mCrossfadeSlider)
+        region.crossfade = value;
+
+    mActiveSample->setRegion(region);
+}
+
+void RegionView::loopToggled()
+{
+    if (mActiveSample == nullptr)
+        return;
+
+    auto region = mActiveSample->getRegion();
+    region.isLooping = mLoopButton.getToggleState();
+
+    // A loop that has never been set covers the whole region.
+    if (region.isLooping && region.loopEnd <= region.loopStart)
+    {
+        region.loopStart = region.start;
+        region.loopEnd = region.end > 0.0 ? region.end : mActiveSample->getTotalRange().getEnd();
+    }
+
+    mActiveSample->setRegion(region);
+}
+
+void RegionView::updateRanges()
+{
+    const double length = mActiveSample != nullptr ? mActiveSample->getTotalRange().getLength() : 0.0;
+    const bool hasSample = length > 0.0;
+
+    // Slider ranges must not be empty, so an empty pad keeps a nominal one.
+    const juce::Range<double> range(0.0, hasSample ? length : 1.0);
+
+    for (auto* slider : { &mStartSlider, &mEndSlider, &mLoopStartSlider, &mLoopEndSlider })
+    {
+        slider->setRange(range, 0.001);
+        slider->setEnabled(hasSample);
+    }
+
+    mCrossfadeSlider.setRange(juce::Range<double>(0.0, juce::jmax(0.001, juce::jmin(1.0, range.getEnd()))), 0.001);
+    mCrossfadeSlider.setEnabled(hasSample);
+    mLoopButton.setEnabled(hasSample);
+}
+
+void RegionView::updateControls(const SampleRegion& region)
+{
+    mStartSlider.setValue(region.start, juce::dontSendNotification);
+    mEndSlider.setValue(region.end > 0.0 ? region.end : mEndSlider.getMaximum(), juce::dontSendNotification);
+    mLoopStartSlider.setValue(region.loopStart, juce::dontSendNotification);
+    mLoopEndSlider.setValue(region.loopEnd, juce::dontSendNotification);
+    mCrossfadeSlider.setValue(region.crossfade, juce::dontSendNotification);
+    mLoopButton.setToggleState(region.isLooping, juce::dontSendNotification);
+
+    const bool canLoop = mLoopButton.isEnabled();
+    mLoopStartSlider.setEnabled(canLoop && region.isLooping);
+    mLoopEndSlider.setEnabled(canLoop && region.isLooping);
+    mCrossfadeSlider.setEnabled(canLoop && region.isLooping);
+}
+
+void RegionView::lookAndFeelChanged()
+{
+    if (!dynamic_cast<juce::LookAndFeel_V4*>(&getLookAndFeel()))
+    {
+        for (auto* label : { &mStartLabel, &mEndLabel, &mLoopStartLabel, &mLoopEndLabel, &mCrossfadeLabel })
+            label->setColour(juce::Label::textColourId, getLookAndFeel().findColour(AppColors::ColourIds::TextPrimary));
+
+        mLoopButton.setColour(juce::ToggleButton::textColourId, getLookAndFeel().findColour(AppColors::ColourIds::TextPrimary));
+    }
+}
@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    RegionView.h
+    Created: 18 Oct 2026 5:02:14am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "Model.h"
+#include "UIConfig.h"
+
+// The active pad's play region and loop, in seconds from the start of its
+// sample.
+class RegionView : public juce::Component,
+    public juce::Slider::Listener,
+    private DataModel::Listener,
+    private SampleModel::Listener
+{
+public:
+    RegionView(const DataModel&);
+    ~RegionView() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+    void lookAndFeelChanged() override;
+
+private:
+    // Sample model listener
+    void regionChanged(SampleRegion) override;
+    void totalRangeChanged(juce::Range<double>) override;
+
+    // Data model listener
+    void activeSampleChanged(SampleModel&) override;
+
+    // Slider listener
+    void sliderValueChanged(juce::Slider*) override;
+
+    void loopToggled();
+    void updateRanges();
+    void updateControls(const SampleRegion&);
+
+    juce::Slider mStartSlider, mEndSlider, mLoopStartSlider, mLoopEndSlider, mCrossfadeSlider;
+    juce::Label mStartLabel, mEndLabel, mLoopStartLabel, mLoopEndLabel, mCrossfadeLabel;
+    juce::ToggleButton mLoopButton { "Loop" };
+
+    DataModel mDataModel;
+    std::unique_ptr<SampleModel> mActiveSample;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RegionView)
+};
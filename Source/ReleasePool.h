@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    ReleasePool.h
+    Created: 17 Oct 2026 3:05:20pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <vector>
+
+// Keeps an extra reference to every object that is handed to the audio
+// thread. When the audio thread drops its reference it can therefore never
+// be the last owner, and the actual delete happens later in
+// collectGarbage(), which is called from a timer on the message thread.
+template <typename ObjectType>
+class ReleasePool
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<ObjectType>;
+
+    ReleasePool() = default;
+
+    // Must not be called from the audio thread.
+    void add(const Ptr& object)
+    {
+        if (object == nullptr)
+            return;
+
+        const juce::ScopedLock sl(lock);
+
+        if (std::find(pool.begin(), pool.end(), object) == pool.end())
+            pool.push_back(object);
+    }
+
+    // Releases every object that is no longer referenced outside the pool.
+    void collectGarbage()
+    {
+        std::vector<Ptr> unused;
+
+        {
+            const juce::ScopedLock sl(lock);
+
+            auto it = std::partition(pool.begin(), pool.end(), [](const Ptr& object)
+                {
+                    return object->getReferenceCount() > 1;
+                });
+
+            std::move(it, pool.end(), std::back_inserter(unused));
+            pool.erase(it, pool.end());
+        }
+
+        // Objects are destroyed here, outside the lock.
+    }
+
+    int size() const
+    {
+        const juce::ScopedLock sl(lock);
+        return static_cast<int>(pool.size());
+    }
+
+private:
+    juce::CriticalSection lock;
+    std::vector<Ptr> pool;
+
+    JUCE_DECLARE_NON_COPYABLE(ReleasePool)
+};
@@ -0,0 +1,280 @@
+/*
+  ==============================================================================
+
+    RenderKernels.h
+    Created: 17 Oct 2026 9:02:11am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Block-oriented building blocks for ExtendedSamplerVoice::renderNextBlock.
+// A voice renders in chunks of at most chunkSize samples: positions are
+// computed for the whole chunk first, source frames are gathered into
+// contiguous tap arrays, and the interpolation itself runs in SIMD lanes.
+// Anything that does not fill a whole register falls back to scalar code.
+//
+// All kernels share the signature (src, ramp, dest, num) so that the voice
+// can switch between them once per chunk. src is either a float pointer or
+// any source with `float operator[](int)`, which lets packed or integer
+// storage be converted while the taps are gathered. Positions are 32.32
+// fixed point, so the frame index and the fraction come out of a shift
+// and a mask rather than a float-to-int conversion.
+namespace RenderKernels
+{
+    constexpr int chunkSize = 64;
+    constexpr size_t alignment = 32;
+
+   #if JUCE_USE_SIMD
+    using FloatVec = juce::dsp::SIMDRegister<float>;
+    constexpr int vecSize = static_cast<int>(FloatVec::size());
+   #else
+    constexpr int vecSize = 1;
+   #endif
+
+    // Furthest any kernel reads before and after the frame at a position.
+    constexpr int maxTapsBefore = 3;
+    constexpr int maxTapsAfter = 4;
+
+    //==============================================================================
+    // A source position: the frame in the upper 32 bits, the fraction of the
+    // way to the next frame in the lower 32.
+    using Phase = juce::uint64;
+
+    constexpr int phaseBits = 32;
+    constexpr Phase phaseOne = Phase(1) << phaseBits;
+    constexpr Phase fractionMask = phaseOne - 1;
+
+    inline Phase toPhase(double frames) noexcept { return static_cast<Phase>(frames * (double)phaseOne + 0.5); }
+    inline Phase toPhase(int frame) noexcept { return static_cast<Phase>(frame) << phaseBits; }
+    inline double toFrames(Phase phase) noexcept { return static_cast<double>(phase) / (double)phaseOne; }
+
+    inline int getIndex(Phase phase) noexcept { return static_cast<int>(phase >> phaseBits); }
+    inline juce::uint32 getFractionBits(Phase phase) noexcept { return static_cast<juce::uint32>(phase & fractionMask); }
+
+    inline float getFraction(Phase phase) noexcept
+    {
+        // Through int64, which converts to float in one instruction; uint32
+        // does not on every target.
+        return static_cast<float>(static_cast<juce::int64>(phase & fractionMask)) * (1.0f / (float)phaseOne);
+    }
+
+    // The positions of a chunk: start, start + increment, ...
+    struct PhaseRamp
+    {
+        Phase start = 0;
+        Phase increment = phaseOne;
+
+        Phase at(int i) const noexcept { return start + increment * static_cast<Phase>(i); }
+    };
+
+    //==============================================================================
+    // Linear interpolation of src along ramp. dest must point to a chunk
+    // buffer aligned to `alignment`.
+    template <typename Source>
+    void interpolateLinear(Source src, PhaseRamp ramp, float* dest, int num) noexcept
+    {
+        jassert(num <= chunkSize);
+
+        alignas(alignment) float tap0[chunkSize];
+        alignas(alignment) float tap1[chunkSize];
+        alignas(alignment) float alpha[chunkSize];
+
+        for (int i = 0; i < num; ++i, ramp.start += ramp.increment)
+        {
+            const int index = getIndex(ramp.start);
+            alpha[i] = getFraction(ramp.start);
+            tap0[i] = src[index];
+            tap1[i] = src[index + 1];
+        }
+
+        int i = 0;
+
+       #if JUCE_USE_SIMD
+        const auto one = FloatVec::expand(1.0f);
+
+        for (; i + vecSize <= num; i += vecSize)
+        {
+            const auto a = FloatVec::fromRawArray(alpha + i);
+            const auto x0 = FloatVec::fromRawArray(tap0 + i);
+            const auto x1 = FloatVec::fromRawArray(tap1 + i);
+
+            (x0 * (one - a) + x1 * a).copyToRawArray(dest + i);
+        }
+       #endif
+
+        for (; i < num; ++i)
+            dest[i] = tap0[i] * (1.0f - alpha[i]) + tap1[i] * alpha[i];
+    }
+
+    // 4-point, 3rd order Hermite interpolation.
+    template <typename Source>
+    void interpolateHermite(Source src, PhaseRamp ramp, float* dest, int num) noexcept
+    {
+        jassert(num <= chunkSize);
+
+        alignas(alignment) float tapM1[chunkSize];
+        alignas(alignment) float tap0[chunkSize];
+        alignas(alignment) float tap1[chunkSize];
+        alignas(alignment) float tap2[chunkSize];
+        alignas(alignment) float alpha[chunkSize];
+
+        for (int i = 0; i < num; ++i, ramp.start += ramp.increment)
+        {
+            const int pos = getIndex(ramp.start);
+            alpha[i] = getFraction(ramp.start);
+            tapM1[i] = src[juce::jmax(0, pos - 1)];
+            tap0[i] = src[pos];
+            tap1[i] = src[pos + 1];
+            tap2[i] = src[pos + 2];
+        }
+
+        int i = 0;
+
+       #if JUCE_USE_SIMD
+        const auto half = FloatVec::expand(0.5f);
+        const auto oneAndHalf = FloatVec::expand(1.5f);
+        const auto two = FloatVec::expand(2.0f);
+        const auto twoAndHalf = FloatVec::expand(2.5f);
+
+        for (; i + vecSize <= num; i += vecSize)
+        {
+            const auto a = FloatVec::fromRawArray(alpha + i);
+            const auto xm1 = FloatVec::fromRawArray(tapM1 + i);
+            const auto x0 = FloatVec::fromRawArray(tap0 + i);
+            const auto x1 = FloatVec::fromRawArray(tap1 + i);
+            const auto x2 = FloatVec::fromRawArray(tap2 + i);
+
+            const auto c1 = half * (x1 - xm1);
+            const auto c2 = xm1 - twoAndHalf * x0 + two * x1 - half * x2;
+            const auto c3 = half * (x2 - xm1) + oneAndHalf * (x0 - x1);
+
+            (((c3 * a + c2) * a + c1) * a + x0).copyToRawArray(dest + i);
+        }
+       #endif
+
+        for (; i < num; ++i)
+        {
+            const float a = alpha[i];
+            const float c1 = 0.5f * (tap1[i] - tapM1[i]);
+            const float c2 = tapM1[i] - 2.5f * tap0[i] + 2.0f * tap1[i] - 0.5f * tap2[i];
+            const float c3 = 0.5f * (tap2[i] - tapM1[i]) + 1.5f * (tap0[i] - tap1[i]);
+
+            dest[i] = ((c3 * a + c2) * a + c1) * a + tap0[i];
+        }
+    }
+
+    //==============================================================================
+    // Blackman-windowed sinc coefficients for numPhases fractional offsets.
+    // The table is immutable after construction, so a single instance can be
+    // shared by every voice of a synthesiser.
+    class SincTable
+    {
+    public:
+        static constexpr int numTaps = 8;
+        static constexpr int phaseTableBits = 8;
+        static constexpr int numPhases = 1 << phaseTableBits;
+
+        // Taps cover src[index - tapOffset] .. src[index - tapOffset + numTaps - 1].
+        static constexpr int tapOffset = numTaps / 2 - 1;
+
+        SincTable()
+        {
+            constexpr double cutoff = 0.9;
+
+            for (int phase = 0; phase <= numPhases; ++phase)
+            {
+                const double fraction = static_cast<double>(phase) / numPhases;
+                double sum = 0.0;
+
+                for (int tap = 0; tap < numTaps; ++tap)
+                {
+                    const double x = (tap - tapOffset) - fraction;
+                    const double sinc = x == 0.0 ? 1.0
+                        : std::sin(juce::MathConstants<double>::pi * cutoff * x) / (juce::MathConstants<double>::pi * cutoff * x);
+
+                    // Window centred on the interpolation point, spanning all taps.
+                    const double w = (x + numTaps / 2.0) / numTaps;
+                    const double window = 0.42 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * w)
+                        + 0.08 * std::cos(2.0 * juce::MathConstants<double>::twoPi * w);
+
+                    coefficients[phase][tap] = static_cast<float>(sinc * window);
+                    sum += sinc * window;
+                }
+
+                // Normalise each phase for unity gain at DC.
+                for (int tap = 0; tap < numTaps; ++tap)
+                    coefficients[phase][tap] = static_cast<float>(coefficients[phase][tap] / sum);
+            }
+        }
+
+        // Rounds the fraction of a Phase to the nearest table entry.
+        const float* getPhase(juce::uint32 fractionBits) const noexcept
+        {
+            constexpr int shift = phaseBits - phaseTableBits;
+            return coefficients[(static_cast<Phase>(fractionBits) + (Phase(1) << (shift - 1))) >> shift];
+        }
+
+    private:
+        alignas(alignment) float coefficients[numPhases + 1][numTaps];
+
+        JUCE_DECLARE_NON_COPYABLE(SincTable)
+    };
+
+    static_assert(SincTable::tapOffset <= maxTapsBefore
+        && SincTable::numTaps - SincTable::tapOffset - 1 <= maxTapsAfter, "Sinc taps exceed the kernel reach");
+
+    // Polyphase windowed-sinc interpolation. Taps and coefficients are
+    // gathered into per-tap arrays so the multiply-accumulate runs across
+    // output samples in SIMD lanes, like the other kernels.
+    template <typename Source>
+    void interpolateSinc(const SincTable& table, Source src, PhaseRamp ramp, float* dest, int num) noexcept
+    {
+        jassert(num <= chunkSize);
+
+        constexpr int numTaps = SincTable::numTaps;
+
+        alignas(alignment) float taps[numTaps][chunkSize];
+        alignas(alignment) float coeffs[numTaps][chunkSize];
+
+        for (int i = 0; i < num; ++i, ramp.start += ramp.increment)
+        {
+            const float* phase = table.getPhase(getFractionBits(ramp.start));
+            const int first = getIndex(ramp.start) - SincTable::tapOffset;
+
+            for (int t = 0; t < numTaps; ++t)
+            {
+                taps[t][i] = src[juce::jmax(0, first + t)];
+                coeffs[t][i] = phase[t];
+            }
+        }
+
+        int i = 0;
+
+       #if JUCE_USE_SIMD
+        for (; i + vecSize <= num; i += vecSize)
+        {
+            auto acc = FloatVec::fromRawArray(taps[0] + i) * FloatVec::fromRawArray(coeffs[0] + i);
+
+            for (int t = 1; t < numTaps; ++t)
+                acc += FloatVec::fromRawArray(taps[t] + i) * FloatVec::fromRawArray(coeffs[t] + i);
+
+            acc.copyToRawArray(dest + i);
+        }
+       #endif
+
+        for (; i < num; ++i)
+        {
+            float acc = 0.0f;
+
+            for (int t = 0; t < numTaps; ++t)
+                acc += taps[t][i] * coeffs[t][i];
+
+            dest[i] = acc;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    Resampler.cpp
+    Created: 17 Oct 2026 8:35:06pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "Resampler.h"
+
+OfflineResampler::OfflineResampler(double sourceRate, double targetRate)
+{
+    jassert(sourceRate > 0 && targetRate > 0);
+
+    step = sourceRate / targetRate;
+
+    // Cutoff relative to the source Nyquist frequency. Downsampling has to
+    // band-limit to the target rate, which also widens the kernel.
+    const double cutoff = 0.95 * juce::jmin(1.0, targetRate / sourceRate);
+    const double halfWidth = numZeroCrossings / cutoff;
+
+    tapOffset = (int)std::ceil(halfWidth) - 1;
+    numTaps = 2 * (tapOffset + 1);
+    coefficients.resize((size_t)(numPhases + 1) * (size_t)numTaps);
+
+    for (int phase = 0; phase <= numPhases; ++phase)
+    {
+        const double fraction = static_cast<double>(phase) / numPhases;
+        float* c = coefficients.data() + (size_t)phase * (size_t)numTaps;
+        double sum = 0.0;
+
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            const double x = (tap - tapOffset) - fraction;
+            const double arg = juce::MathConstants<double>::pi * cutoff * x;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(arg) / arg;
+
+            // Blackman window over [-halfWidth, halfWidth].
+            const double w = juce::jlimit(0.0, 1.0, (x + halfWidth) / (2.0 * halfWidth));
+            const double window = 0.42 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * w)
+                + 0.08 * std::cos(2.0 * juce::MathConstants<double>::twoPi * w);
+
+            c[tap] = static_cast<float>(sinc * window);
+            sum += sinc * window;
+        }
+
+        // Normalise each phase for unity gain at DC.
+        for (int tap = 0; tap < numTaps; ++tap)
+            c[tap] = static_cast<float>(c[tap] / sum);
+    }
+}
+
+int OfflineResampler::getNumOutputFrames(int numSourceFrames) const noexcept
+{
+    return (int)std::ceil(numSourceFrames / step);
+}
+
+void OfflineResampler::process(const float* src, int numSourceFrames, float* dest, int numOutputFrames) const noexcept
+{
+    for (int n = 0; n < numOutputFrames; ++n)
+    {
+        const double position = n * step;
+        const int index = (int)position;
+
+        // Blend the two nearest phases rather than rounding to one.
+        const double phasePosition = (position - index) * numPhases;
+        const int phase = juce::jmin(numPhases - 1, (int)phasePosition);
+        const float blend = (float)(phasePosition - phase);
+
+        const float* c0 = getPhase(phase);
+        const float* c1 = getPhase(phase + 1);
+
+        const int first = index - tapOffset;
+        const int tapStart = juce::jmax(0, -first);
+        const int tapEnd = juce::jmin(numTaps, numSourceFrames - first);
+
+        float acc = 0.0f;
+
+        for (int tap = tapStart; tap < tapEnd; ++tap)
+            acc += src[first + tap] * (c0[tap] + (c1[tap] - c0[tap]) * blend);
+
+        dest[n] = acc;
+    }
+}
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    Resampler.h
+    Created: 17 Oct 2026 8:35:06pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+//=====================================================================
+// Offline windowed-sinc sample rate converter, used on the loader threads
+// to bring samples to the host rate. It is far too slow for the audio
+// thread, but in exchange the kernel is long enough that the passband is
+// flat to 95% of the lower Nyquist frequency, and when downsampling the
+// cutoff moves down with the target rate so nothing aliases.
+class OfflineResampler
+{
+public:
+    OfflineResampler(double sourceRate, double targetRate);
+
+    // Number of frames numSourceFrames become at the target rate.
+    int getNumOutputFrames(int numSourceFrames) const noexcept;
+
+    // Converts numSourceFrames of src into numOutputFrames of dest. Frames
+    // outside the source are treated as silence.
+    void process(const float* src, int numSourceFrames, float* dest, int numOutputFrames) const noexcept;
+
+private:
+    static constexpr int numZeroCrossings = 16;
+    static constexpr int numPhases = 256;
+
+    const float* getPhase(int phase) const noexcept { return coefficients.data() + (size_t)phase * (size_t)numTaps; }
+
+    double step = 1.0;       // Source frames per output frame
+    int numTaps = 0;
+    int tapOffset = 0;       // Taps cover src[i - tapOffset] .. src[i - tapOffset + numTaps - 1]
+    std::vector<float> coefficients;
+
+    JUCE_DECLARE_NON_COPYABLE(OfflineResampler)
+};
@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+    SampleEncoder.cpp
+    Created: 18 Oct 2026 1:02:19am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "SampleEncoder.h"
+
+SampleEncoder::SampleEncoder()
+    : juce::Thread("Sample encoder")
+{
+    formatManager.registerBasicFormats();
+    startThread(juce::Thread::Priority::background);
+}
+
+SampleEncoder::~SampleEncoder()
+{
+    stopThread(4000);
+    cancelPendingUpdate();
+}
+
+bool SampleEncoder::isCurrent(const juce::File& file, const FileIdentity& identity) const
+{
+    return !file.existsAsFile() || identity.matches(file);
+}
+
+SampleEncoder::Encoded SampleEncoder::find(const juce::File& file) const
+{
+    const juce::ScopedLock sl(lock);
+    const auto it = byPath.find(file.getFullPathName());
+
+    if (it == byPath.end() || !isCurrent(file, it->second.identity))
+        return {};
+
+    return it->second;
+}
+
+void SampleEncoder::request(const juce::File& file, const FileIdentity& known)
+{
+    const auto path = file.getFullPathName();
+
+    {
+        const juce::ScopedLock sl(lock);
+        const auto it = byPath.find(path);
+
+        if (it != byPath.end() && isCurrent(file, it->second.identity))
+            return;
+
+        if (inProgress == path)
+            return;
+
+        for (const auto& queued : requests)
+            if (queued.first.getFullPathName() == path)
+                return;
+
+        requests.push_back({ file, known });
+    }
+
+    notify();
+}
+
+void SampleEncoder::add(const juce::File& file, const Encoded& encoded)
+{
+    if (encoded.flac == nullptr)
+        return;
+
+    const juce::ScopedLock sl(lock);
+    byPath[file.getFullPathName()] = encoded;
+
+    if (encoded.identity.isHashed())
+        byHash[encoded.identity.contentHash] = encoded.flac;
+}
+
+void SampleEncoder::retainOnly(const juce::StringArray& paths)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto it = byPath.begin(); it != byPath.end();)
+        it = paths.contains(it->first) ? std::next(it) : byPath.erase(it);
+
+    requests.erase(std::remove_if(requests.begin(), requests.end(),
+        [&](const auto& queued) { return !paths.contains(queued.first.getFullPathName()); }), requests.end());
+
+    // An encode that is no longer wanted stops at its next chunk.
+    if (!paths.contains(inProgress))
+        inProgress.clear();
+
+    byHash.clear();
+
+    for (const auto& entry : byPath)
+        if (entry.second.identity.isHashed())
+            byHash[entry.second.identity.contentHash] = entry.second.flac;
+}
+
+void SampleEncoder::run()
+{
+    while (!threadShouldExit())
+    {
+        juce::File file;
+        FileIdentity known;
+
+        {
+            const juce::ScopedLock sl(lock);
+
+            if (!requests.empty())
+            {
+                std::tie(file, known) = requests.front();
+                requests.pop_front();
+                inProgress = file.getFullPathName();
+            }
+        }
+
+        if (file == juce::File())
+        {
+            wait(-1);
+            continue;
+        }
+
+        SamplePool::Key key;
+        FileIdentity identity;
+        Data flac;
+
+        if (SamplePool::makeKey(file, SamplePool::Form::decoded, key, known))
+        {
+            identity = key.getIdentity();
+
+            {
+                const juce::ScopedLock sl(lock);
+                const auto it = byHash.find(identity.contentHash);
+
+                if (it != byHash.end())
+                    flac = it->second;
+            }
+
+            if (flac == nullptr)
+                flac = encode(file);
+        }
+
+        {
+            const juce::ScopedLock sl(lock);
+
+            // Dropped by retainOnly while it was being encoded.
+            const bool isWanted = inProgress == file.getFullPathName();
+            inProgress.clear();
+
+            if (flac == nullptr || !isWanted)
+                continue;
+
+            byPath[file.getFullPathName()] = { identity, flac };
+            byHash[identity.contentHash] = flac;
+        }
+
+        triggerAsyncUpdate();
+    }
+}
+
+SampleEncoder::Data SampleEncoder::encode(const juce::File& file)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+    if (reader == nullptr || reader->sampleRate <= 0 || reader->numChannels == 0 || reader->lengthInSamples <= 0)
+        return nullptr;
+
+    const bool isFloatSource = reader->usesFloatingPointData || reader->bitsPerSample > 24;
+    const int bitsPerSample = !isFloatSource && reader->bitsPerSample <= 16 ? 16 : 24;
+
+    // The sampler plays at most two channels.
+    const int numChannels = juce::jmin(2, (int)reader->numChannels);
+
+    auto block = std::make_shared<juce::MemoryBlock>();
+    auto stream = std::make_unique<juce::MemoryOutputStream>(*block, false);
+
+    juce::FLACAudioFormat flac;
+    std::unique_ptr<juce::AudioFormatWriter> writer(flac.createWriterFor(stream.get(), reader->sampleRate,
+        (unsigned int)numChannels, bitsPerSample, {}, 5));
+
+    if (writer == nullptr)
+        return nullptr;
+
+    stream.release();
+
+    const auto path = file.getFullPathName();
+    constexpr int chunkFrames = 1 << 16;
+
+    for (juce::int64 start = 0; start < reader->lengthInSamples; start += chunkFrames)
+    {
+        {
+            const juce::ScopedLock sl(lock);
+
+            if (inProgress != path)
+                return nullptr;
+        }
+
+        if (threadShouldExit())
+            return nullptr;
+
+        const auto num = (int)juce::jmin((juce::int64)chunkFrames, reader->lengthInSamples - start);
+
+        if (!writer->writeFromAudioReader(*reader, start, num))
+            return nullptr;
+    }
+
+    // Deleting the writer finishes the stream.
+    writer.reset();
+    return block;
+}
+
+void SampleEncoder::handleAsyncUpdate()
+{
+    if (onEncoded != nullptr)
+        onEncoded();
+}
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    SampleEncoder.h
+    Created: 18 Oct 2026 1:02:19am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <map>
+#include <memory>
+#include "SamplePool.h"
+
+//=====================================================================
+// Encodes sample files to FLAC for embedding in the plugin state, on a
+// background thread of its own. Files are encoded a chunk at a time, so a
+// long file never holds up a shutdown or a newer request for long.
+//
+// Results are cached by content hash. A state save only looks up what has
+// already been encoded and queues anything missing, so saving never waits
+// on an encode, and saving again does not encode anything a second time.
+// Files shared by several pads, or copied under another name, are encoded
+// once.
+//
+// FLAC stores integers of up to 24 bits. Integer sources are encoded
+// losslessly; float sources are stored at 24 bits.
+class SampleEncoder : private juce::Thread,
+                      private juce::AsyncUpdater
+{
+public:
+    using Data = std::shared_ptr<const juce::MemoryBlock>;
+
+    struct Encoded
+    {
+        FileIdentity identity;    // Of the file the data was encoded from
+        Data flac;                // nullptr if nothing has been encoded
+    };
+
+    SampleEncoder();
+    ~SampleEncoder() override;
+
+    // Thread-safe. The encoded data for file, unless there is none or the
+    // file has changed since it was encoded. A file that no longer exists
+    // keeps the data it had, since that is all that is left of it.
+    Encoded find(const juce::File&) const;
+
+    // Thread-safe. Queues file to be encoded unless find() would already
+    // return it. known may hold the file's identity, to skip hashing it.
+    void request(const juce::File&, const FileIdentity& known = {});
+
+    // Thread-safe. Adds data restored from a saved state.
+    void add(const juce::File&, const Encoded&);
+
+    // Thread-safe. Drops the data and requests of every file not in paths.
+    void retainOnly(const juce::StringArray& paths);
+    void clear() { retainOnly({}); }
+
+    // Called on the message thread when more data has been encoded.
+    std::function<void()> onEncoded;
+
+private:
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    bool isCurrent(const juce::File&, const FileIdentity&) const;
+    Data encode(const juce::File&);
+
+    juce::AudioFormatManager formatManager;
+
+    std::map<juce::String, Encoded> byPath;
+    std::map<juce::uint64, Data> byHash;
+    std::deque<std::pair<juce::File, FileIdentity>> requests;
+    juce::String inProgress;    // Path of the file being encoded
+    juce::CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleEncoder)
+};
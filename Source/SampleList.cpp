@@ -38,7 +38,14 @@ void SampleButton::paint(juce::Graphics& g)
         g.setColour(getLookAndFeel().findColour(AppColors::ColourIds::ActionActive));
 
     g.setFont(12.0f);
-    g.drawText("Button", getLocalBounds().reduced(10), juce::Justification::topLeft, true);
+    juce::String status("Button");
+
+    if (model.getLoadState() == LoadState::loading)
+        status = "Loading...";
+    else if (model.getLoadState() == LoadState::failed)
+        status = "Load failed";
+
+    g.drawText(status, getLocalBounds().reduced(10), juce::Justification::topLeft, true);
     g.drawText(model.getName(), getLocalBounds(), juce::Justification::centred, true);
 }
 
@@ -64,6 +71,13 @@ void SampleButton::isActiveChanged(bool isActive)
 }
 
 
+void SampleButton::loadStateChanged(LoadState)
+{
+    setTooltip(model.getLoadError());
+    repaint();
+}
+
+
 void SampleButton::updateText()
 {
     setButtonText(model.getName());
@@ -91,22 +105,26 @@ void SampleButton::filesDropped(const juce::StringArray& files, int x, int y)
 {
     auto localPoint = getLocalPoint(this, juce::Point<int>(x, y));
 
+    // Check if the drop location is within the bounds of the button
+    if (!getLocalBounds().contains(localPoint))
+        return;
+
+    juce::Array<juce::File> dropped;
+
     for (auto filePath : files)
-    {
         if (isInterestedInFileDrag(filePath))
-        {
-            // Check if the drop location is within the bounds of the button
-            if (getLocalBounds().contains(localPoint))
-            {
-                const juce::File file(filePath);
-                model.setAudioFile(file);
-                model.setName(file.getFileNameWithoutExtension());
-
-                // Update button or perform other actions
-                model.setIsActive(true);
-            }
-        }
-    }
+            dropped.add(juce::File(filePath));
+
+    if (dropped.isEmpty())
+        return;
+
+    // Several files play round-robin, or with shift held, as velocity
+    // layers in the order they were dropped.
+    model.setAudioFiles(dropped, juce::ModifierKeys::getCurrentModifiers().isShiftDown());
+    model.setName(dropped.getFirst().getFileNameWithoutExtension());
+
+    // Update button or perform other actions
+    model.setIsActive(true);
 }
 
 
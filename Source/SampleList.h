@@ -34,6 +34,7 @@ private:
     // Sample model listener 
     void nameChanged(juce::String) override;  
     void isActiveChanged(bool) override; 
+    void loadStateChanged(LoadState) override; 
 
     void filesDropped(const juce::StringArray& files, int x, int y) override;
     bool isInterestedInFileDrag(const juce::StringArray& files) override;
@@ -0,0 +1,607 @@
+/*
+  ==============================================================================
+
+    SampleLoader.cpp
+    Created: 17 Oct 2026 1:26:48pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "SampleLoader.h"
+#include "ReaderFactory.h"
+
+namespace
+{
+    // Where an uncompressed WAV or AIFF file keeps its frames, and their
+    // byte order, read from the file's own chunks.
+    struct MappedLayout
+    {
+        size_t dataOffset = 0;
+        bool bigEndian = false;
+    };
+
+    juce::uint32 readTag(const char* p) noexcept
+    {
+        return juce::ByteOrder::bigEndianInt(p);
+    }
+
+    bool findMappedLayout(const char* data, size_t size, MappedLayout& layout)
+    {
+        constexpr size_t headerSize = 12, chunkHeaderSize = 8;
+
+        if (size < headerSize)
+            return false;
+
+        const auto container = readTag(data);
+        const auto type = readTag(data + 8);
+
+        const bool isWave = (container == readTag("RIFF") || container == readTag("RF64")) && type == readTag("WAVE");
+        const bool isAiff = container == readTag("FORM") && (type == readTag("AIFF") || type == readTag("AIFC"));
+
+        if (!isWave && !isAiff)
+            return false;
+
+        // AIFF is big-endian; AIFC says in its COMM chunk, where 'sowt'
+        // marks little-endian integers.
+        layout.bigEndian = isAiff;
+
+        for (size_t pos = headerSize; pos + chunkHeaderSize <= size;)
+        {
+            const auto id = readTag(data + pos);
+            const size_t chunkSize = isWave ? juce::ByteOrder::littleEndianInt(data + pos + 4)
+                                            : juce::ByteOrder::bigEndianInt(data + pos + 4);
+            const size_t body = pos + chunkHeaderSize;
+
+            if (isWave && id == readTag("data"))
+            {
+                layout.dataOffset = body;
+                return true;
+            }
+
+            if (isAiff && id == readTag("COMM") && type == readTag("AIFC") && chunkSize >= 22 && body + 22 <= size)
+            {
+                const auto compression = readTag(data + body + 18);
+
+                if (compression == readTag("sowt"))
+                    layout.bigEndian = false;
+                else if (compression != readTag("NONE") && compression != readTag("twos")
+                      && compression != readTag("fl32") && compression != readTag("FL32"))
+                    return false;
+            }
+
+            // COMM may follow SSND, so keep walking until both are seen.
+            if (isAiff && id == readTag("SSND") && body + 8 <= size)
+            {
+                // The frames start after the chunk's offset and block size
+                // fields, plus the offset itself.
+                layout.dataOffset = body + 8 + juce::ByteOrder::bigEndianInt(data + body);
+            }
+
+            // Chunks are padded to an even length. An RF64 data chunk's
+            // size is in ds64, but the data chunk is always found first.
+            pos = body + chunkSize + (chunkSize & 1);
+        }
+
+        return layout.dataOffset > 0;
+    }
+
+    // Compares a run of frames from each of the start, middle and end of the
+    // sample with the reader's own decoding. The byte order is already
+    // known from the header; this catches a layout that was misread.
+    bool storageMatchesReader(const SampleStorage& storage, juce::AudioFormatReader& reader)
+    {
+        constexpr int runLength = 32;
+        const int numToCheck = juce::jmin(runLength, storage.numFrames);
+        juce::AudioBuffer<float> expected((int)reader.numChannels, numToCheck);
+
+        for (const int start : { 0, (storage.numFrames - numToCheck) / 2, storage.numFrames - numToCheck })
+        {
+            if (!reader.read(&expected, 0, numToCheck, start, true, true))
+                return false;
+
+            for (int ch = 0; ch < storage.numChannels; ++ch)
+            {
+                float actual[runLength];
+                storage.readFrames(ch, start, numToCheck, actual);
+
+                for (int i = 0; i < numToCheck; ++i)
+                    if (std::abs(actual[i] - expected.getSample(ch, i)) > 1.0e-6f)
+                        return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+//================================================================================
+// A decode queued on the shared pool, tagged with its loader so a loader
+// that goes away removes only its own jobs.
+class SampleLoader::DecodeJob : public juce::ThreadPoolJob
+{
+public:
+    DecodeJob(SampleLoader& loader, std::function<void()> work)
+        : juce::ThreadPoolJob("Sample decode"),
+        owner(loader),
+        decodeZone(std::move(work))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        decodeZone();
+        owner.numPendingJobs.fetch_sub(1, std::memory_order_relaxed);
+        return jobHasFinished;
+    }
+
+    SampleLoader& owner;
+
+private:
+    std::function<void()> decodeZone;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodeJob)
+};
+
+//================================================================================
+SampleLoader::SampleLoader()
+{
+    formatManager.registerBasicFormats();
+}
+
+SampleLoader::~SampleLoader()
+{
+    struct OwnJobs : public juce::ThreadPool::JobSelector
+    {
+        explicit OwnJobs(SampleLoader& loader) : owner(loader) {}
+
+        bool isJobSuitable(juce::ThreadPoolJob* job) override
+        {
+            auto* decodeJob = dynamic_cast<DecodeJob*> (job);
+            return decodeJob != nullptr && &decodeJob->owner == &owner;
+        }
+
+        SampleLoader& owner;
+    };
+
+    // Other instances' jobs keep running; this one's are dropped, or waited
+    // for if they have started.
+    OwnJobs ownJobs(*this);
+    pool->removeAllJobs(true, 10000, &ownJobs);
+    cancelPendingUpdate();
+}
+
+void SampleLoader::cancel(int id)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    // Jobs already queued finish, but their results are a generation old.
+    ++latestGeneration[id];
+    pending.erase(id);
+}
+
+void SampleLoader::load(const std::vector<SampleZone>& zones, int midiNote, int id)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    jassert(!zones.empty());
+
+    if (zones.empty())
+    {
+        cancel(id);
+        return;
+    }
+
+    const int generation = ++latestGeneration[id];
+
+    auto& pad = pending[id];
+    pad = {};
+    pad.generation = generation;
+    pad.midiNote = midiNote;
+    pad.name = zones.front().file.getFileNameWithoutExtension();
+    pad.numRemaining = (int)zones.size();
+
+    for (const auto& zone : zones)
+    {
+        ExtendedSamplerSound::Zone loaded;
+        loaded.lowVelocity = zone.lowVelocity;
+        loaded.highVelocity = zone.highVelocity;
+        pad.zones.push_back(std::move(loaded));
+    }
+
+    // The pool runs jobs in the order they were added, so the first layer's
+    // zones go in ahead of the rest.
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (size_t i = 0; i < zones.size(); ++i)
+        {
+            const bool isFirstLayer = zones[i].lowVelocity == zones.front().lowVelocity
+                                   && zones[i].highVelocity == zones.front().highVelocity;
+
+            if (isFirstLayer != (pass == 0))
+                continue;
+
+            if (isFirstLayer)
+                ++pad.numFirstLayerRemaining;
+
+            numPendingJobs.fetch_add(1, std::memory_order_relaxed);
+
+            pool->addJob(new DecodeJob(*this, [this, zone = zones[i], known = getKnownFile(zones[i].file), zoneIndex = (int)i, id, generation, jobSettings = settings]
+                {
+                    decode(zone, known, zoneIndex, id, generation, jobSettings);
+                }), true);
+        }
+    }
+}
+
+SampleData::Ptr SampleLoader::createMappedData(const juce::File& file, const Settings& jobSettings)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+    if (reader == nullptr || reader->sampleRate <= 0 || reader->numChannels == 0
+        || reader->lengthInSamples <= 0 || reader->lengthInSamples > std::numeric_limits<int>::max())
+        return nullptr;
+
+    // Frames that have to be resampled cannot be played in place.
+    if (jobSettings.targetSampleRate > 0 && reader->sampleRate != jobSettings.targetSampleRate)
+        return nullptr;
+
+    // A long file is streamed instead, so it is never read in full at load
+    // and its pages are never faulted in on the audio thread.
+    const auto& streaming = jobSettings.streaming;
+
+    if (streaming.enabled && (double)reader->lengthInSamples / reader->sampleRate > streaming.thresholdSeconds)
+        return nullptr;
+
+    SampleStorage storage;
+
+    if (reader->usesFloatingPointData && reader->bitsPerSample == 32)
+        storage.encoding = SampleStorage::Encoding::float32;
+    else if (!reader->usesFloatingPointData && reader->bitsPerSample == 16)
+        storage.encoding = SampleStorage::Encoding::int16;
+    else if (!reader->usesFloatingPointData && reader->bitsPerSample == 24)
+        storage.encoding = SampleStorage::Encoding::int24;
+    else
+        return nullptr;
+
+    auto mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    const auto* mapped = static_cast<const char*> (mapping->getData());
+    const auto mappedSize = mapping->getSize();
+
+    MappedLayout layout;
+
+    if (mapped == nullptr || !findMappedLayout(mapped, mappedSize, layout))
+        return nullptr;
+
+    const int bytesPerSample = (int)reader->bitsPerSample / 8;
+    const size_t bytesPerFrame = (size_t)bytesPerSample * reader->numChannels;
+
+    if (layout.dataOffset + (size_t)reader->lengthInSamples * bytesPerFrame > mappedSize)
+        return nullptr;
+
+    storage.bigEndian = layout.bigEndian;
+    storage.numChannels = juce::jmin(2, (int)reader->numChannels);
+    storage.stride = (int)reader->numChannels;
+    storage.numFrames = (int)reader->lengthInSamples;
+
+    for (int ch = 0; ch < storage.numChannels; ++ch)
+        storage.channels[ch] = mapped + layout.dataOffset + (size_t)(ch * bytesPerSample);
+
+    if (!storageMatchesReader(storage, *reader))
+        return nullptr;
+
+    // Fault in the same head a streamed sound preloads, so a note's onset
+    // is unlikely to wait on the disk; the rest is faulted in as it plays.
+    // Nothing keeps the pages resident: under memory pressure the system
+    // may still evict them, and the audio thread would then fault them back
+    // in.
+    const auto headFrames = juce::jmin(reader->lengthInSamples, (juce::int64)(streaming.preloadSeconds * reader->sampleRate));
+    const auto headEnd = juce::jmin(mappedSize, layout.dataOffset + (size_t)headFrames * bytesPerFrame);
+    volatile char sink = 0;
+
+    for (size_t offset = layout.dataOffset; offset < headEnd; offset += 4096)
+        sink = sink + mapped[offset];
+
+    return new SampleData(std::move(mapping), storage, reader->sampleRate);
+}
+
+void SampleLoader::decode(const SampleZone& zone, const FileIdentity& known, int zoneIndex, int id, int generation, Settings jobSettings)
+{
+    const auto& file = zone.file;
+    const bool isEmbedded = zone.embeddedAudio != nullptr;
+
+    Completed job;
+    job.id = id;
+    job.generation = generation;
+    job.zoneIndex = zoneIndex;
+    job.file = file;
+
+    // Hashing reads the whole file, so it is only done for decoded data that
+    // can be pooled, at most once per load, and not at all when the file's
+    // identity is already known to this loader or the pool.
+    SamplePool::Key key;
+    bool hasKey = false, isHashed = false;
+
+    auto findPooled = [&](SamplePool::Form form, double sampleRate) -> SampleData::Ptr
+    {
+        if (form == SamplePool::Form::mapped)
+        {
+            hasKey = SamplePool::makeKey(file, form, key);
+        }
+        else if (!isHashed)
+        {
+            if (isEmbedded)
+            {
+                // Shared between instances restoring the same state, but
+                // kept apart from the file itself: float sources are only
+                // embedded at 24 bits.
+                key.path = "embedded:" + file.getFullPathName();
+                key.modificationTime = known.modificationTime;
+                key.size = known.size;
+                key.contentHash = known.contentHash;
+                hasKey = known.isHashed();
+            }
+            else
+            {
+                hasKey = SamplePool::makeKey(file, form, key, known.isHashed() ? known : samplePool->findIdentity(file));
+            }
+
+            isHashed = true;
+        }
+
+        key.form = form;
+        key.sampleRate = sampleRate;
+        return hasKey ? samplePool->find(key) : nullptr;
+    };
+
+    auto addPooled = [&](SampleData::Ptr data) -> SampleData::Ptr
+    {
+        return hasKey && data != nullptr ? samplePool->add(key, std::move(data)) : data;
+    };
+
+    SampleData::Ptr sample;
+
+    if (jobSettings.memoryMap && !isEmbedded)
+    {
+        sample = findPooled(SamplePool::Form::mapped, 0.0);
+
+        if (sample == nullptr)
+            sample = addPooled(createMappedData(file, jobSettings));
+    }
+
+    const auto pooledForm = jobSettings.compact ? SamplePool::Form::compact : SamplePool::Form::decoded;
+
+    // When the target rate changes, every pad is loaded again. The pool
+    // still holds the frames the pads were playing, under the same key at
+    // another rate, so they are converted from there instead of decoding
+    // the file again. The highest rate available loses the least. This is
+    // decided before the file is opened, so it is only tried for a file
+    // whose identity is already known: hashing one that turns out to be
+    // streamed would read all of it.
+    const bool isIdentityKnown = !isEmbedded && ((known.isHashed() && known.matches(file))
+                                                 || samplePool->findIdentity(file).isHashed());
+
+    if (sample == nullptr && isIdentityKnown)
+    {
+        findPooled(pooledForm, 0.0);
+        const auto source = hasKey ? samplePool->findHighestRate(key) : nullptr;
+
+        // The current settings may stream it now.
+        const auto& streaming = jobSettings.streaming;
+        const bool wouldStream = source != nullptr && streaming.enabled
+                              && source->getLength() > streaming.thresholdSeconds * source->getSourceSampleRate();
+
+        if (source != nullptr && !wouldStream)
+        {
+            const double targetRate = jobSettings.targetSampleRate > 0 && jobSettings.targetSampleRate != source->getFileSampleRate()
+                                        ? jobSettings.targetSampleRate : 0.0;
+
+            sample = findPooled(pooledForm, targetRate);
+
+            // Frames at the file's own rate have to be the file's own, so
+            // those are only ever decoded from it.
+            if (sample == nullptr && targetRate > 0)
+            {
+                SampleData::Ptr converted = new SampleData(*source, targetRate);
+
+                // Resampled frames are not exact source values anyway, and
+                // normalising keeps the resampler's overshoot from clipping.
+                if (jobSettings.compact)
+                    converted->compactStorage(source->getStorage().encoding, true);
+
+                sample = addPooled(std::move(converted));
+            }
+        }
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+
+    if (isEmbedded)
+        reader = MemoryAudioFormatReaderFactory(zone.embeddedAudio->getData(), zone.embeddedAudio->getSize()).make(formatManager);
+    else if (sample == nullptr)
+        reader.reset(formatManager.createReaderFor(file));
+
+    if (sample != nullptr)
+    {
+        // Mapped in place
+    }
+    else if (reader == nullptr)
+    {
+        job.error = "Unsupported or unreadable file: " + file.getFileName();
+    }
+    else if (reader->sampleRate <= 0 || reader->lengthInSamples <= 0)
+    {
+        job.error = "File contains no audio: " + file.getFileName();
+    }
+    else
+    {
+        const auto lengthSeconds = (double)reader->lengthInSamples / reader->sampleRate;
+        const int length = (int)juce::jmin(reader->lengthInSamples, (juce::int64)std::numeric_limits<int>::max() - SampleData::numPaddingFrames);
+
+        const auto& streaming = jobSettings.streaming;
+
+        // Integer sources keep their own resolution; float sources are
+        // normalised into 24 bits.
+        const bool isFloatSource = reader->usesFloatingPointData || reader->bitsPerSample > 24;
+        const auto compactEncoding = reader->bitsPerSample <= 16 && !isFloatSource ? SampleStorage::Encoding::int16
+                                                                                   : SampleStorage::Encoding::int24;
+
+        // Embedded audio is already in memory, so it is never streamed.
+        if (streaming.enabled && !isEmbedded && lengthSeconds > streaming.thresholdSeconds)
+        {
+            // Each streamed sound needs a reader of its own, so only its
+            // small head would be worth sharing; streamed sounds bypass the
+            // pool. They are not resampled either, since the streamed
+            // remainder would not match. A streamed float head cannot be
+            // normalised independently of the streamed remainder, and is
+            // small anyway.
+            const int preloadFrames = (int)(streaming.preloadSeconds * reader->sampleRate);
+            sample = new SampleData(*reader, preloadFrames, length);
+
+            if (jobSettings.compact && !isFloatSource)
+                sample->compactStorage(compactEncoding, false);
+
+            if (sample->getHeadLength() < sample->getLength())
+                job.streamSource = new StreamSource(std::move(reader), (juce::int64)length + SampleData::numPaddingFrames);
+        }
+        else
+        {
+            // Resampled frames play at the host rate, so a voice at the root
+            // note reads them without interpolating.
+            const double targetRate = jobSettings.targetSampleRate > 0 && jobSettings.targetSampleRate != reader->sampleRate
+                                        ? jobSettings.targetSampleRate : 0.0;
+
+            sample = findPooled(pooledForm, targetRate);
+
+            if (sample == nullptr)
+            {
+                SampleData::Ptr decoded = new SampleData(*reader, length, length);
+
+                if (targetRate > 0)
+                    decoded->resampleTo(targetRate);
+
+                if (jobSettings.compact)
+                    decoded->compactStorage(compactEncoding, isFloatSource);
+
+                sample = addPooled(std::move(decoded));
+            }
+        }
+    }
+
+    job.sample = std::move(sample);
+
+    if (hasKey)
+        job.identity = key.getIdentity();
+
+    {
+        const juce::ScopedLock sl(completedLock);
+        completed.push_back(std::move(job));
+    }
+
+    triggerAsyncUpdate();
+}
+
+void SampleLoader::handleAsyncUpdate()
+{
+    std::vector<Completed> finished;
+
+    {
+        const juce::ScopedLock sl(completedLock);
+        finished.swap(completed);
+    }
+
+    std::vector<int> updatedPads;
+
+    for (auto& job : finished)
+    {
+        // Worth keeping even if the load itself is stale.
+        if (job.identity.isHashed())
+            addKnownFile(job.file, job.identity);
+
+        const auto it = pending.find(job.id);
+
+        if (it == pending.end() || it->second.generation != job.generation)
+            continue;
+
+        auto& pad = it->second;
+        auto& zone = pad.zones[(size_t)job.zoneIndex];
+
+        if (zone.lowVelocity == pad.zones.front().lowVelocity && zone.highVelocity == pad.zones.front().highVelocity)
+            --pad.numFirstLayerRemaining;
+
+        --pad.numRemaining;
+
+        if (job.sample != nullptr)
+        {
+            zone.sample = std::move(job.sample);
+            zone.streamSource = std::move(job.streamSource);
+            pad.hasNewZones = true;
+        }
+        else
+        {
+            pad.errors.add(job.error);
+        }
+
+        if (std::find(updatedPads.begin(), updatedPads.end(), job.id) == updatedPads.end())
+            updatedPads.push_back(job.id);
+    }
+
+    // Each pad is rebuilt at most once per update, however many of its zones
+    // arrived together.
+    for (const int id : updatedPads)
+    {
+        const auto it = pending.find(id);
+        auto& pad = it->second;
+
+        const bool isComplete = pad.numRemaining == 0;
+        const bool wasPublished = pad.isPublished;
+
+        if (pad.hasNewZones && (wasPublished || pad.numFirstLayerRemaining == 0 || isComplete))
+            publish(id, pad);
+
+        Result result;
+        result.id = id;
+        result.state = pad.isPublished ? LoadState::ready : LoadState::failed;
+
+        if (isComplete)
+            result.error = pad.errors.joinIntoString("\n");
+
+        if ((pad.isPublished && !wasPublished) || (isComplete && result.error.isNotEmpty()))
+            listenerList.call([&](Listener& l) { l.sampleLoadFinished(result); });
+
+        if (isComplete)
+            pending.erase(it);
+    }
+}
+
+FileIdentity SampleLoader::getKnownFile(const juce::File& file) const
+{
+    const juce::ScopedLock sl(knownFilesLock);
+    const auto it = knownFiles.find(file.getFullPathName());
+    return it != knownFiles.end() ? it->second : FileIdentity();
+}
+
+void SampleLoader::addKnownFile(const juce::File& file, const FileIdentity& identity)
+{
+    const juce::ScopedLock sl(knownFilesLock);
+    knownFiles[file.getFullPathName()] = identity;
+}
+
+void SampleLoader::publish(int id, PendingPad& pad)
+{
+    std::vector<ExtendedSamplerSound::Zone> loaded;
+
+    for (const auto& zone : pad.zones)
+        if (zone.sample != nullptr)
+            loaded.push_back(zone);
+
+    juce::BigInteger range;
+    range.setRange(pad.midiNote, 1, true);
+
+    ExtendedSamplerSound::Ptr sound = new ExtendedSamplerSound(id, pad.name, std::move(loaded), range, pad.midiNote, .1, .1);
+
+    pad.isPublished = true;
+    pad.hasNewZones = false;
+
+    if (onSoundReady != nullptr)
+        onSoundReady(sound);
+}
@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    SampleLoader.h
+    Created: 17 Oct 2026 1:26:48pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <map>
+#include <vector>
+#include "Model.h"
+#include "SamplePool.h"
+#include "Sampler.h"
+
+//=====================================================================
+// Worker threads shared by every SampleLoader in the process through
+// juce::SharedResourcePointer, so a session with many instances does not
+// start a set of loader threads for each one, all competing for the disk.
+// Jobs from every instance run in the order they were added.
+class SampleLoaderPool : public juce::ThreadPool
+{
+public:
+    SampleLoaderPool()
+        : juce::ThreadPool(juce::jlimit(1, 4, juce::SystemStats::getNumCpus() - 1))
+    {
+    }
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleLoaderPool)
+};
+
+//=====================================================================
+// Decodes sample files and builds ExtendedSamplerSounds on the shared
+// SampleLoaderPool. Finished sounds are handed back on the message thread
+// through onSoundReady, so the audio thread only ever receives a fully
+// constructed sound. If a pad is loaded again before an earlier request
+// finishes, the stale result is dropped.
+//
+// Uncompressed WAV and AIFF files are memory-mapped and played in place
+// when memory mapping is enabled, unless they are longer than the
+// streaming threshold. Files longer than that are not read in full: only
+// their head is preloaded and the rest is streamed by the DiskStreamer.
+//
+// Zones with embedded audio from a saved state are decoded from memory,
+// and never mapped or streamed.
+//
+// With a target sample rate set, decoded samples at another rate are
+// resampled offline, and mapping is skipped for them. When the target
+// changes, frames the pool already holds are resampled rather than
+// decoded from the file again.
+//
+// Decoded and mapped frames come from the process-wide SamplePool, so a
+// file that is already loaded by any pad or plugin instance is neither
+// decoded nor held a second time.
+//
+// A pad may have several zones (velocity layers and round-robin
+// alternatives). Each zone is a job of its own, and the zones of the first
+// layer are queued ahead of the rest. The pad's sound is delivered as soon
+// as that layer is complete, and delivered again with more zones as the
+// others finish, so a large multi-sample pad is playable almost at once.
+class SampleLoader : private juce::AsyncUpdater
+{
+public:
+    struct Result
+    {
+        int id = -1;
+        LoadState state = LoadState::empty;
+        juce::String error;
+    };
+
+    class Listener
+    {
+    public:
+        virtual ~Listener() noexcept = default;
+        virtual void sampleLoadFinished(const Result&) {}
+    };
+
+    SampleLoader();
+    ~SampleLoader() override;
+
+    // Message thread only. zones must not be empty; the first zone's layer
+    // is loaded first.
+    void load(const std::vector<SampleZone>& zones, int midiNote, int id);
+    void load(const juce::File& file, int midiNote, int id) { load({ SampleZone { file } }, midiNote, id); }
+    // Drops the pad's load in progress, if any, so no sound is delivered.
+    void cancel(int id);
+
+    // Message thread only. Applies to subsequent loads.
+    void setStreamingOptions(const StreamingOptions& newOptions) { settings.streaming = newOptions; }
+    const StreamingOptions& getStreamingOptions() const noexcept { return settings.streaming; }
+
+    // Message thread only. Apply to subsequent loads.
+    void setMemoryMappingEnabled(bool shouldMap) { settings.memoryMap = shouldMap; }
+    void setCompactStorageEnabled(bool shouldCompact) { settings.compact = shouldCompact; }
+
+    // Message thread only. In-memory samples recorded at another rate are
+    // resampled to this one as they load; 0 keeps every file's own rate.
+    void setTargetSampleRate(double newRate) { settings.targetSampleRate = newRate; }
+    double getTargetSampleRate() const noexcept { return settings.targetSampleRate; }
+
+    // Called on the message thread with each successfully built sound. A pad
+    // with several zones may be delivered more than once while it loads.
+    std::function<void(ExtendedSamplerSound::Ptr)> onSoundReady;
+
+    // Identities of files this loader has hashed, or was told about by
+    // addKnownFile (e.g. from a saved project), so a file that has not
+    // changed is not read twice just to hash it.
+    FileIdentity getKnownFile(const juce::File&) const;
+    void addKnownFile(const juce::File&, const FileIdentity&);
+
+    // Thread-safe. This loader's zones queued or being decoded.
+    int getNumPendingJobs() const noexcept { return numPendingJobs.load(std::memory_order_relaxed); }
+
+    // Shared with every other SampleLoader in the process.
+    SamplePool& getSamplePool() noexcept { return *samplePool; }
+
+    void addListener(Listener& listener) { listenerList.add(&listener); }
+    void removeListener(Listener& listener) { listenerList.remove(&listener); }
+
+private:
+    struct Completed
+    {
+        int id = -1;
+        int generation = 0;
+        int zoneIndex = 0;
+        SampleData::Ptr sample;    // nullptr if the zone failed to load
+        StreamSource::Ptr streamSource;
+        juce::String error;
+        juce::File file;
+        FileIdentity identity;     // Unhashed unless the file was decoded into the pool
+    };
+
+    // A pad whose zones are still arriving.
+    struct PendingPad
+    {
+        int generation = 0;
+        int midiNote = 0;
+        juce::String name;
+        std::vector<ExtendedSamplerSound::Zone> zones;    // In request order
+        int numRemaining = 0;
+        int numFirstLayerRemaining = 0;
+        bool isPublished = false;
+        bool hasNewZones = false;
+        juce::StringArray errors;
+    };
+
+    // Copied into each job so later changes do not affect loads in flight.
+    struct Settings
+    {
+        StreamingOptions streaming;
+        bool memoryMap = true;
+        bool compact = false;
+        double targetSampleRate = 0.0;
+    };
+
+    class DecodeJob;
+
+    void decode(const SampleZone&, const FileIdentity& known, int zoneIndex, int id, int generation, Settings);
+    void publish(int id, PendingPad&);
+    SampleData::Ptr createMappedData(const juce::File& file, const Settings&);
+    void handleAsyncUpdate() override;
+
+    juce::AudioFormatManager formatManager;
+    juce::SharedResourcePointer<SamplePool> samplePool;
+
+    juce::CriticalSection completedLock;
+    std::vector<Completed> completed;
+
+    // Message thread only.
+    Settings settings;
+    std::map<int, int> latestGeneration;
+    std::map<int, PendingPad> pending;
+    std::map<juce::String, FileIdentity> knownFiles;
+    // The host may save state from a thread other than the message thread.
+    juce::CriticalSection knownFilesLock;
+    juce::ListenerList<Listener> listenerList;
+
+    juce::SharedResourcePointer<SampleLoaderPool> pool;
+    std::atomic<int> numPendingJobs { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleLoader)
+};
@@ -0,0 +1,406 @@
+/*
+  ==============================================================================
+
+    SamplePool.cpp
+    Created: 17 Oct 2026 7:48:22pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "SamplePool.h"
+#include "Resampler.h"
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+namespace
+{
+    // 64-bit FNV-1a over whole words. This only has to tell apart versions of
+    // one file, so speed matters more than distribution.
+    juce::uint64 hashBlock(juce::uint64 hash, const char* bytes, size_t numBytes) noexcept
+    {
+        constexpr juce::uint64 prime = 0x100000001b3ull;
+
+        size_t i = 0;
+
+        for (; i + sizeof(juce::uint64) <= numBytes; i += sizeof(juce::uint64))
+        {
+            juce::uint64 word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            hash = (hash ^ word) * prime;
+        }
+
+        for (; i < numBytes; ++i)
+            hash = (hash ^ (juce::uint8)bytes[i]) * prime;
+
+        return hash;
+    }
+}
+
+//================================================================================
+SampleData::SampleData(juce::AudioFormatReader& source, int numFramesToRead, int totalLength)
+    : sourceSampleRate(source.sampleRate),
+    fileSampleRate(source.sampleRate)
+{
+    if (sourceSampleRate > 0 && totalLength > 0)
+    {
+        length = totalLength;
+        headLength = juce::jlimit(0, length, numFramesToRead);
+
+        data.reset(new juce::AudioBuffer<float>(juce::jmin(2, (int)source.numChannels), headLength + numPaddingFrames));
+
+        source.read(data.get(), 0, headLength + numPaddingFrames, 0, true, true);
+        useDecodedData();
+        findAudibleLength();
+    }
+}
+
+SampleData::SampleData(std::unique_ptr<juce::MemoryMappedFile> mapped, const SampleStorage& layout, double sampleRate)
+    : mapping(std::move(mapped)),
+    storage(layout),
+    sourceSampleRate(sampleRate),
+    fileSampleRate(sampleRate)
+{
+    // There is no padding after a mapping; the voice reads the last few
+    // frames through its window instead.
+    length = storage.numFrames;
+    headLength = length;
+    findAudibleLength();
+}
+
+SampleData::SampleData(const SampleData& source, double targetRate)
+    : sourceSampleRate(source.sourceSampleRate),
+    fileSampleRate(source.fileSampleRate)
+{
+    jassert(source.headLength == source.length);
+
+    const auto& frames = source.getStorage();
+
+    if (frames.isEmpty() || source.headLength != source.length)
+        return;
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    length = source.length;
+    headLength = length;
+
+    data.reset(new juce::AudioBuffer<float>(frames.numChannels, length + numPaddingFrames));
+
+    for (int ch = 0; ch < frames.numChannels; ++ch)
+    {
+        frames.readFrames(ch, 0, length, data->getWritePointer(ch));
+        juce::FloatVectorOperations::multiply(data->getWritePointer(ch), frames.scale, length);
+        data->clear(ch, length, numPaddingFrames);
+    }
+
+    useDecodedData();
+    conversionMilliseconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+
+    if (targetRate > 0 && targetRate != sourceSampleRate)
+        resampleTo(targetRate);
+    else
+        findAudibleLength();
+}
+
+void SampleData::useDecodedData()
+{
+    storage = {};
+    storage.encoding = SampleStorage::Encoding::float32;
+    storage.bigEndian = juce::ByteOrder::isBigEndian();
+    storage.numChannels = data->getNumChannels();
+    storage.numFrames = data->getNumSamples();
+
+    for (int ch = 0; ch < storage.numChannels; ++ch)
+        storage.channels[ch] = data->getReadPointer(ch);
+}
+
+void SampleData::findAudibleLength()
+{
+    // The streamed remainder is not known yet.
+    if (headLength < length)
+    {
+        audibleLength = length;
+        return;
+    }
+
+    constexpr int blockSize = 256;
+    float block[blockSize];
+    int end = 0;
+
+    // Most samples end in a short fade, so scanning back from the end stops
+    // early; a mapped file only has its last pages touched.
+    for (int blockEnd = length; blockEnd > 0 && end == 0; blockEnd -= blockSize)
+    {
+        const int blockStart = juce::jmax(0, blockEnd - blockSize);
+
+        for (int ch = 0; ch < storage.numChannels; ++ch)
+        {
+            storage.readFrames(ch, blockStart, blockEnd - blockStart, block);
+
+            for (int i = blockEnd - blockStart; --i >= 0;)
+            {
+                if (std::abs(block[i]) > silenceLevel)
+                {
+                    end = juce::jmax(end, blockStart + i + 1);
+                    break;
+                }
+            }
+        }
+    }
+
+    audibleLength = juce::jmin(length, end + numPaddingFrames);
+}
+
+void SampleData::resampleTo(double targetRate)
+{
+    jassert(getReferenceCount() <= 1); // Shared data must not change
+    jassert(headLength == length);     // The streamed remainder would not match
+
+    if (data == nullptr || targetRate <= 0 || targetRate == sourceSampleRate || headLength != length)
+        return;
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    const OfflineResampler resampler(sourceSampleRate, targetRate);
+    const int newLength = resampler.getNumOutputFrames(length);
+
+    std::unique_ptr<juce::AudioBuffer<float>> resampled(new juce::AudioBuffer<float>(data->getNumChannels(), newLength + numPaddingFrames));
+
+    for (int ch = 0; ch < data->getNumChannels(); ++ch)
+    {
+        resampler.process(data->getReadPointer(ch), length, resampled->getWritePointer(ch), newLength);
+        resampled->clear(ch, newLength, numPaddingFrames);
+    }
+
+    data = std::move(resampled);
+    sourceSampleRate = targetRate;
+    length = newLength;
+    headLength = newLength;
+    useDecodedData();
+    findAudibleLength();
+
+    conversionMilliseconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+}
+
+void SampleData::compactStorage(SampleStorage::Encoding encoding, bool normaliseToPeak)
+{
+    jassert(getReferenceCount() <= 1); // Shared data must not change
+
+    if (data == nullptr || encoding == SampleStorage::Encoding::float32)
+        return;
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    const bool isInt16 = encoding == SampleStorage::Encoding::int16;
+    const int bytesPerSample = isInt16 ? 2 : 3;
+    const int numChannels = data->getNumChannels();
+    const int numFrames = data->getNumSamples();
+
+    // Same full-scale factors AudioData uses when reading, so integer
+    // sources decoded to float come back to exactly the same values.
+    const double fullScale = isInt16 ? 32768.0 : 8388608.0;
+    const int minValue = -(int)fullScale;
+    const int maxValue = (int)fullScale - 1;
+
+    float scale = 1.0f;
+
+    if (normaliseToPeak)
+    {
+        const float peak = data->getMagnitude(0, numFrames);
+
+        if (peak > 0.0f)
+            scale = peak;
+    }
+
+    packedBytes = (size_t)numChannels * (size_t)numFrames * (size_t)bytesPerSample;
+    packedData.malloc(packedBytes);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* src = data->getReadPointer(ch);
+        char* dest = packedData.get() + (size_t)ch * (size_t)numFrames * (size_t)bytesPerSample;
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            const int value = juce::jlimit(minValue, maxValue, juce::roundToInt(src[i] / scale * fullScale));
+
+            if (isInt16)
+                reinterpret_cast<juce::int16*> (dest)[i] = (juce::int16)value;
+            else
+                juce::ByteOrder::littleEndian24BitToChars(value, dest + 3 * i);
+        }
+
+        storage.channels[ch] = dest;
+    }
+
+    storage.encoding = encoding;
+    storage.bigEndian = isInt16 && juce::ByteOrder::isBigEndian();
+    storage.stride = 1;
+    storage.scale = scale;
+
+    data.reset();
+
+    conversionMilliseconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+}
+
+size_t SampleData::getResidentBytes() const noexcept
+{
+    if (data != nullptr)
+        return (size_t)data->getNumChannels() * (size_t)data->getNumSamples() * sizeof(float);
+
+    return packedBytes;
+}
+
+size_t SampleData::getFloatEquivalentBytes() const noexcept
+{
+    return (size_t)storage.numChannels * (size_t)storage.numFrames * sizeof(float);
+}
+
+size_t SampleData::getMappedBytes() const noexcept
+{
+    if (!isMemoryMapped())
+        return 0;
+
+    return (size_t)storage.numFrames * (size_t)storage.stride * (size_t)storage.getBytesPerSample();
+}
+
+//================================================================================
+bool SamplePool::Key::operator< (const Key& other) const noexcept
+{
+    return std::tie(contentHash, size, modificationTime, form, sampleRate, path)
+         < std::tie(other.contentHash, other.size, other.modificationTime, other.form, other.sampleRate, other.path);
+}
+
+bool SamplePool::makeKey(const juce::File& file, Form form, Key& result, const FileIdentity& known)
+{
+    result.path = file.getFullPathName();
+    result.modificationTime = file.getLastModificationTime().toMilliseconds();
+    result.form = form;
+
+    if (form == Form::mapped)
+    {
+        result.size = file.getSize();
+        result.contentHash = 0;
+        return file.existsAsFile();
+    }
+
+    if (known.isHashed() && known.modificationTime == result.modificationTime && known.size == file.getSize())
+    {
+        result.size = known.size;
+        result.contentHash = known.contentHash;
+        return true;
+    }
+
+    juce::FileInputStream stream(file);
+
+    if (stream.failedToOpen())
+        return false;
+
+    result.size = stream.getTotalLength();
+
+    juce::HeapBlock<char> block(1 << 16);
+    juce::uint64 hash = 0xcbf29ce484222325ull;
+
+    for (;;)
+    {
+        const int numRead = stream.read(block.get(), 1 << 16);
+
+        if (numRead <= 0)
+            break;
+
+        hash = hashBlock(hash, block.get(), (size_t)numRead);
+    }
+
+    result.contentHash = hash;
+    return stream.isExhausted();
+}
+
+SampleData::Ptr SamplePool::find(const Key& key) const
+{
+    const juce::ScopedLock sl(lock);
+    const auto it = entries.find(key);
+
+    return it != entries.end() ? it->second : nullptr;
+}
+
+FileIdentity SamplePool::findIdentity(const juce::File& file) const
+{
+    const auto path = file.getFullPathName();
+    const auto size = file.getSize();
+    const auto modificationTime = file.getLastModificationTime().toMilliseconds();
+
+    const juce::ScopedLock sl(lock);
+
+    for (const auto& entry : entries)
+    {
+        const auto& key = entry.first;
+
+        if (key.contentHash != 0 && key.path == path && key.size == size && key.modificationTime == modificationTime)
+            return key.getIdentity();
+    }
+
+    return {};
+}
+
+SampleData::Ptr SamplePool::findHighestRate(const Key& key) const
+{
+    const juce::ScopedLock sl(lock);
+    SampleData::Ptr best;
+
+    for (const auto& entry : entries)
+    {
+        const auto& other = entry.first;
+
+        if (other.contentHash != key.contentHash || other.size != key.size || other.modificationTime != key.modificationTime
+            || other.form != key.form || other.path != key.path)
+            continue;
+
+        if (best == nullptr || entry.second->getSourceSampleRate() > best->getSourceSampleRate())
+            best = entry.second;
+    }
+
+    return best;
+}
+
+SampleData::Ptr SamplePool::add(const Key& key, SampleData::Ptr data)
+{
+    jassert(data != nullptr);
+
+    const juce::ScopedLock sl(lock);
+    auto& entry = entries[key];
+
+    if (entry == nullptr)
+        entry = std::move(data);
+
+    return entry;
+}
+
+void SamplePool::collectGarbage()
+{
+    std::vector<SampleData::Ptr> unused;
+
+    {
+        const juce::ScopedLock sl(lock);
+
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            if (it->second->getReferenceCount() > 1)
+            {
+                ++it;
+                continue;
+            }
+
+            unused.push_back(std::move(it->second));
+            it = entries.erase(it);
+        }
+    }
+
+    // Entries are destroyed here, outside the lock.
+}
+
+int SamplePool::size() const
+{
+    const juce::ScopedLock sl(lock);
+    return static_cast<int>(entries.size());
+}
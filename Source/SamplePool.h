@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+    SamplePool.h
+    Created: 17 Oct 2026 7:48:22pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <vector>
+#include "SampleStorage.h"
+
+//=====================================================================
+// The frames of a sample, decoded or memory-mapped, and how they are laid
+// out. A SampleData is immutable once it has been published, so any number
+// of sounds, in any number of plugin instances, may play from it at once.
+class SampleData : public juce::ReferenceCountedObject
+{
+public:
+    // Frames read past the end of the sample so interpolation kernels can
+    // look ahead without bounds checks.
+    static constexpr int numPaddingFrames = 8;
+
+    using Ptr = juce::ReferenceCountedObjectPtr<SampleData>;
+
+    // Decodes the first numFramesToRead frames of source. length is the
+    // full length of the sample, which is longer than numFramesToRead when
+    // the remainder is streamed.
+    SampleData(juce::AudioFormatReader& source, int numFramesToRead, int length);
+
+    // Frames are read in place from the mapping, laid out as described by
+    // layout. The file should already be mapped and pre-faulted.
+    SampleData(std::unique_ptr<juce::MemoryMappedFile> mapping, const SampleStorage& layout, double sampleRate);
+
+    // Decodes a float copy of source's frames, in any encoding, and
+    // resamples it to targetRate unless that is 0. source must be fully
+    // loaded, not streamed.
+    SampleData(const SampleData& source, double targetRate);
+
+    // Converts the decoded frames to targetRate with an OfflineResampler.
+    // Only for fully decoded float data; must be called before the data is
+    // compacted or shared.
+    void resampleTo(double targetRate);
+
+    // Repacks the decoded frames as int16 or packed int24 and frees the float
+    // buffer. With normaliseToPeak the frames are scaled to full range and
+    // the peak is kept as the storage scale; otherwise integer sources
+    // round-trip exactly. Must be called before the data is shared.
+    void compactStorage(SampleStorage::Encoding, bool normaliseToPeak);
+
+    const SampleStorage& getStorage() const noexcept { return storage; }
+    double getSourceSampleRate() const noexcept { return sourceSampleRate; }
+
+    // Rate of the file the frames came from, which resampling leaves as is.
+    double getFileSampleRate() const noexcept { return fileSampleRate; }
+
+    // headLength frames are held in memory; unless the sample is streamed
+    // it equals length.
+    int getLength() const noexcept { return length; }
+    int getHeadLength() const noexcept { return headLength; }
+
+    // Frames up to the end of the last sample above silenceLevel, plus a few
+    // for interpolation to ring out. Voices stop here rather than render a
+    // silent tail. Equal to length for streamed samples.
+    int getAudibleLength() const noexcept { return audibleLength; }
+
+    // -120 dB
+    static constexpr float silenceLevel = 1.0e-6f;
+
+    // nullptr for memory-mapped and compact data.
+    const juce::AudioBuffer<float>* getAudioData() const noexcept { return data.get(); }
+    bool isMemoryMapped() const noexcept { return mapping != nullptr; }
+
+    size_t getResidentBytes() const noexcept;
+    size_t getFloatEquivalentBytes() const noexcept;
+    size_t getMappedBytes() const noexcept;
+    double getConversionMilliseconds() const noexcept { return conversionMilliseconds; }
+
+private:
+    void useDecodedData();
+    void findAudibleLength();
+
+    std::unique_ptr<juce::AudioBuffer<float>> data;
+    std::unique_ptr<juce::MemoryMappedFile> mapping;
+    juce::HeapBlock<char> packedData;
+    size_t packedBytes = 0;
+    double conversionMilliseconds = 0.0;
+    SampleStorage storage;
+    double sourceSampleRate = 0.0, fileSampleRate = 0.0;
+    int length = 0, headLength = 0, audibleLength = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleData)
+};
+
+//=====================================================================
+// A file's size, modification time and content hash. A file whose size
+// and modification time still match is taken to hold the same data, so a
+// hash saved with a project can be reused without reading the file again.
+struct FileIdentity
+{
+    juce::int64 modificationTime = 0;
+    juce::int64 size = 0;
+    juce::uint64 contentHash = 0;
+
+    bool isHashed() const noexcept { return contentHash != 0; }
+
+    // True if file has this size and modification time.
+    bool matches(const juce::File& file) const
+    {
+        return file.getSize() == size && file.getLastModificationTime().toMilliseconds() == modificationTime;
+    }
+};
+
+//=====================================================================
+// Process-wide cache of SampleData, shared by every pad and every plugin
+// instance through juce::SharedResourcePointer. Entries are keyed by the
+// file's path, modification time, size and a hash of its contents, plus
+// the form and rate the frames are held in, so the same file loaded once
+// as float and once compacted yields two entries. Mapped entries leave the
+// hash out.
+//
+// The pool holds a reference to every entry. collectGarbage() drops the
+// entries nobody else refers to, so the memory is reclaimed on the thread
+// that calls it (the message thread) once the last sound is gone.
+class SamplePool
+{
+public:
+    enum class Form
+    {
+        decoded = 0,
+        compact,
+        mapped
+    };
+
+    struct Key
+    {
+        juce::String path;
+        juce::int64 modificationTime = 0;
+        juce::int64 size = 0;
+        juce::uint64 contentHash = 0;
+        Form form = Form::decoded;
+        double sampleRate = 0.0;    // Rate the frames were converted to, or 0 for the file's own
+
+        bool operator< (const Key&) const noexcept;
+        FileIdentity getIdentity() const noexcept { return { modificationTime, size, contentHash }; }
+    };
+
+    SamplePool() = default;
+
+    // Reads the whole file to hash it, unless known matches the file's
+    // size and modification time. Mapped data is read in place from its own
+    // file, so sharing it between copies saves nothing; its key is never
+    // hashed. Returns false if the file cannot be read.
+    static bool makeKey(const juce::File&, Form, Key& result, const FileIdentity& known = {});
+
+    // Thread-safe. Returns nullptr if the pool holds no data for key.
+    SampleData::Ptr find(const Key&) const;
+
+    // Thread-safe. The hashed identity of an entry for file, if its size and
+    // modification time still match, so loading it again skips the hash.
+    // Unhashed if there is none.
+    FileIdentity findIdentity(const juce::File&) const;
+
+    // Thread-safe. Of the entries that differ from key only in their rate,
+    // the one at the highest rate, which loses the least when converted to
+    // another. nullptr if there is none.
+    SampleData::Ptr findHighestRate(const Key&) const;
+
+    // Thread-safe. Adds data unless another thread got there first, in which
+    // case the existing entry is returned and data is left to be released
+    // by the caller.
+    SampleData::Ptr add(const Key&, SampleData::Ptr data);
+
+    // Releases every entry that is no longer referenced outside the pool.
+    void collectGarbage();
+
+    int size() const;
+
+private:
+    juce::CriticalSection lock;
+    std::map<Key, SampleData::Ptr> entries;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SamplePool)
+};
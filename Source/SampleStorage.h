@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+    SampleStorage.h
+    Created: 17 Oct 2026 6:12:37pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "Model.h"
+
+//=====================================================================
+// Describes where a sound's frames live and how they are encoded, so the
+// render kernels can read them in place. Float buffers we decoded
+// ourselves are read as plain pointers; anything else (interleaved,
+// integer or big-endian data, e.g. a memory-mapped WAV or AIFF) goes
+// through a PackedSource that converts each tap to float as it is
+// gathered.
+struct SampleStorage
+{
+    enum class Encoding
+    {
+        float32 = 0,
+        int16,
+        int24
+    };
+
+    static constexpr int numEncodings = 3;
+
+    Encoding encoding = Encoding::float32;
+    bool bigEndian = false;
+
+    // First sample of each channel, and the distance in samples between
+    // consecutive frames of one channel.
+    const void* channels[2] {};
+    int numChannels = 0;
+    int stride = 1;
+
+    // Frames that may be addressed directly, including any padding after
+    // the end of the sample.
+    int numFrames = 0;
+
+    // Applied to the interpolated output rather than to every tap.
+    float scale = 1.0f;
+
+    bool isEmpty() const noexcept { return numChannels == 0; }
+
+    int getBytesPerSample() const noexcept
+    {
+        return encoding == Encoding::int16 ? 2 : encoding == Encoding::int24 ? 3 : 4;
+    }
+
+    // Calls fn with a source for the channel that supports
+    // `float operator[](int frame)`.
+    template <typename Fn>
+    void visit(int channel, Fn&& fn) const;
+
+    // Converts frames [start, start + num) of a channel to float. All of them
+    // must lie below numFrames.
+    void readFrames(int channel, int start, int num, float* dest) const noexcept
+    {
+        visit(channel, [&](auto src)
+            {
+                for (int i = 0; i < num; ++i)
+                    dest[i] = src[start + i];
+            });
+    }
+
+    // Returns frames [start, start + num) of a channel as float: in place if
+    // they are stored as contiguous native floats, otherwise converted into
+    // scratch.
+    const float* getFrames(int channel, int start, int num, float* scratch) const noexcept
+    {
+        if (encoding == Encoding::float32 && stride == 1 && bigEndian == juce::ByteOrder::isBigEndian())
+            return static_cast<const float*> (channels[channel]) + start;
+
+        readFrames(channel, start, num, scratch);
+        return scratch;
+    }
+};
+
+// Memory used by a set of sounds, as returned by
+// WalsheeySampleAudioProcessor::getStorageReport.
+struct StorageReport
+{
+    // Counted per zone, so a pad with layers counts once for each sample.
+    int numSounds = 0;
+    int numCompactSounds = 0;
+
+    // Zones that play a sample already counted for another zone or pad.
+    int numSharedSounds = 0;
+
+    // Sample memory actually held, and what the same sounds would take as
+    // 32-bit float. Memory-mapped frames are counted separately because
+    // the OS can page them out.
+    size_t residentBytes = 0;
+    size_t floatEquivalentBytes = 0;
+    size_t mappedBytes = 0;
+
+    // Time spent resampling and repacking samples on the loader threads.
+    double conversionMilliseconds = 0.0;
+
+    // Mean time to render one sample of one voice playing from each
+    // encoding, indexed by SampleStorage::Encoding, since the instance
+    // started. Covers reading and interpolating the frames, not the voice
+    // filter. Zero until a voice has played from that encoding.
+    std::array<double, SampleStorage::numEncodings> renderNanosecondsPerSample {};
+
+    // The same, for voices that interpolate with each mode, indexed by
+    // InterpolationMode. Voices playing at the sample's own rate read the
+    // frames without interpolating and are left out.
+    std::array<double, numInterpolationModes> interpolationNanosecondsPerSample {};
+
+    size_t getBytesSaved() const noexcept
+    {
+        return floatEquivalentBytes > residentBytes ? floatEquivalentBytes - residentBytes : 0;
+    }
+};
+
+//=====================================================================
+template <typename Format, typename Endianness>
+struct PackedSource
+{
+    using Pointer = juce::AudioData::Pointer<Format, Endianness, juce::AudioData::Interleaved, juce::AudioData::Const>;
+
+    PackedSource(const void* data, int stride) noexcept
+        : base(data, stride) {}
+
+    float operator[](int frame) const noexcept
+    {
+        auto p = base;
+        p += frame;
+        return p.getAsFloat();
+    }
+
+    Pointer base;
+};
+
+template <typename Fn>
+void SampleStorage::visit(int channel, Fn&& fn) const
+{
+    using namespace juce;
+    jassert(isPositiveAndBelow(channel, numChannels));
+
+    const void* data = channels[channel];
+
+    switch (encoding)
+    {
+    case Encoding::int16:
+        if (bigEndian)
+            fn(PackedSource<AudioData::Int16, AudioData::BigEndian>(data, stride));
+        else
+            fn(PackedSource<AudioData::Int16, AudioData::LittleEndian>(data, stride));
+        break;
+
+    case Encoding::int24:
+        if (bigEndian)
+            fn(PackedSource<AudioData::Int24, AudioData::BigEndian>(data, stride));
+        else
+            fn(PackedSource<AudioData::Int24, AudioData::LittleEndian>(data, stride));
+        break;
+
+    case Encoding::float32:
+    default:
+        if (stride == 1 && bigEndian == ByteOrder::isBigEndian())
+            fn(static_cast<const float*> (data));
+        else if (bigEndian)
+            fn(PackedSource<AudioData::Float32, AudioData::BigEndian>(data, stride));
+        else
+            fn(PackedSource<AudioData::Float32, AudioData::LittleEndian>(data, stride));
+        break;
+    }
+}
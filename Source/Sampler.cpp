@@ -10,37 +10,177 @@
 
 #include "Sampler.h"
 
+namespace
+{
+    using PlayRegion = ExtendedSamplerSound::PlayRegion;
+
+    // Resolves region to frames of sample. A sample that was resampled at
+    // load converts at its new rate, so the same seconds are played.
+    PlayRegion resolveRegion(const SampleRegion& region, const SampleData& sample, bool isStreamed)
+    {
+        using namespace RenderKernels;
+
+        const double rate = sample.getSourceSampleRate();
+        const int length = sample.getLength();
+        auto toFrame = [&](double seconds) { return juce::jlimit(0, length, juce::roundToInt(seconds * rate)); };
+
+        PlayRegion result;
+        result.end = region.end > 0.0 ? juce::jmax(1, toFrame(region.end)) : length;
+        result.start = juce::jmin(toFrame(region.start), result.end - 1);
+
+        // A streamed zone must start inside its head, where the stream takes
+        // over from.
+        if (isStreamed)
+            result.start = juce::jmin(result.start, juce::jmax(0, sample.getHeadLength() - 1));
+
+        const int loopStart = toFrame(region.loopStart);
+        const int loopEnd = juce::jmin(toFrame(region.loopEnd), result.end);
+
+        if (!region.isLooping || loopEnd - loopStart < ExtendedSamplerSound::minLoopFrames
+            || result.start >= loopEnd || (isStreamed && loopEnd > sample.getHeadLength()))
+            return result;
+
+        result.isLooping = true;
+        result.loopStart = loopStart;
+        result.loopEnd = loopEnd;
+
+        // The crossfade blends the end of the loop with the frames leading up
+        // to loopStart, so it is limited by both; a loop starting at frame 0
+        // has nothing to blend in and wraps without a crossfade. The frames after loopStart
+        // copied into the tail must come before the fade.
+        const int numFade = juce::jlimit(0, juce::jmin(loopStart, loopEnd - loopStart - maxTapsAfter - 1),
+            juce::roundToInt(region.crossfade * rate));
+
+        result.fadeStart = loopEnd - numFade;
+
+        // The last few fade frames are fully faded in, so the taps that read
+        // back from loopStart after a wrap see the same frames as before it.
+        const int numRamp = numFade - juce::jmin(maxTapsBefore, numFade);
+
+        const auto& storage = sample.getStorage();
+        result.loopTail.setSize(storage.numChannels, numFade + maxTapsAfter + 1);
+        juce::HeapBlock<float> lead((size_t)juce::jmax(1, numFade));
+
+        for (int ch = 0; ch < storage.numChannels; ++ch)
+        {
+            float* tail = result.loopTail.getWritePointer(ch);
+            storage.readFrames(ch, result.fadeStart, numFade, tail);
+            storage.readFrames(ch, loopStart - numFade, numFade, lead.get());
+
+            for (int i = 0; i < numFade; ++i)
+            {
+                // Equal power: the gains are cos and sin of the same angle, so
+                // their squares sum to one. That keeps the level steady over
+                // the uncorrelated material either side of a loop, where a
+                // linear fade dips.
+                const float t = i < numRamp ? ((float)i + 0.5f) / (float)numRamp : 1.0f;
+                const float angle = t * juce::MathConstants<float>::halfPi;
+                tail[i] = tail[i] * std::cos(angle) + lead[i] * std::sin(angle);
+            }
+
+            storage.readFrames(ch, loopStart, maxTapsAfter + 1, tail + numFade);
+        }
+
+        return result;
+    }
+}
+
 //================================================================================
-ExtendedSamplerSound::ExtendedSamplerSound(const juce::String& soundName,
-    juce::AudioFormatReader& source,
+ExtendedSamplerSound::ExtendedSamplerSound(int padId,
+    const juce::String& soundName,
+    std::vector<Zone> zonesToPlay,
     const juce::BigInteger& notes,
     int midiNoteForNormalPitch,
     double attackTimeSecs,
     double releaseTimeSecs,
-    double maxSampleLengthSeconds)
-    : name(soundName),
-    sourceSampleRate(source.sampleRate),
+    const SampleRegion& regionToPlay)
+    : id(padId),
+    name(soundName),
     midiNotes(notes),
-    midiRootNote(midiNoteForNormalPitch)
+    midiRootNote(midiNoteForNormalPitch),
+    region(regionToPlay)
 {
-    if (sourceSampleRate > 0 && source.lengthInSamples > 0)
+    jassert(!zonesToPlay.empty());
+
+    // Zones with the same velocity range become one layer, kept together
+    // in the order they were given so round-robin follows that order.
+    zones.reserve(zonesToPlay.size());
+
+    for (size_t i = 0; i < zonesToPlay.size(); ++i)
+    {
+        // Zones already moved into an earlier layer are left empty.
+        if (zonesToPlay[i].sample == nullptr)
+            continue;
+
+        const int low = zonesToPlay[i].lowVelocity, high = zonesToPlay[i].highVelocity;
+        Layer layer;
+        layer.firstZone = (int)zones.size();
+
+        for (size_t j = i; j < zonesToPlay.size(); ++j)
+        {
+            auto& zone = zonesToPlay[j];
+
+            if (zone.sample != nullptr && zone.lowVelocity == low && zone.highVelocity == high)
+            {
+                zones.push_back(std::move(zone));
+                ++layer.numZones;
+            }
+        }
+
+        layers.push_back(layer);
+    }
+
+    jassert(!layers.empty());
+
+    for (auto& zone : zones)
+        zone.region = resolveRegion(region, *zone.sample, zone.streamSource != nullptr);
+
+    // Velocities outside every layer fall back to the closest one.
+    for (int velocity = 0; velocity < (int)velocityToLayer.size(); ++velocity)
     {
-        length = juce::jmin((int)source.lengthInSamples,
-            (int)(maxSampleLengthSeconds * sourceSampleRate));
+        int best = 0, bestDistance = std::numeric_limits<int>::max();
 
-        data.reset(new juce::AudioBuffer<float>(juce::jmin(2, (int)source.numChannels), length + 4));
+        for (int l = 0; l < (int)layers.size(); ++l)
+        {
+            const auto& zone = zones[(size_t)layers[(size_t)l].firstZone];
+            const int distance = velocity < zone.lowVelocity ? zone.lowVelocity - velocity
+                               : velocity > zone.highVelocity ? velocity - zone.highVelocity : 0;
 
-        source.read(data.get(), 0, length + 4, 0, true, true);
+            if (distance < bestDistance)
+            {
+                best = l;
+                bestDistance = distance;
+            }
+        }
 
-        params.attack = static_cast<float> (attackTimeSecs);
-        params.release = static_cast<float> (releaseTimeSecs);
+        velocityToLayer[(size_t)velocity] = (juce::uint8)best;
     }
+
+    params.attack = static_cast<float> (attackTimeSecs);
+    params.release = static_cast<float> (releaseTimeSecs);
 }
 
 ExtendedSamplerSound::~ExtendedSamplerSound()
 {
 }
 
+ExtendedSamplerSound::Ptr ExtendedSamplerSound::withRegion(const SampleRegion& newRegion) const
+{
+    // params may be changing on the audio thread, so the defaults are used.
+    return new ExtendedSamplerSound(id, name, zones, midiNotes, midiRootNote, .1, .1, newRegion);
+}
+
+const ExtendedSamplerSound::Zone& ExtendedSamplerSound::selectZone(float velocity) noexcept
+{
+    const int v = juce::jlimit(0, 127, juce::roundToInt(velocity * 127.0f));
+    auto& layer = layers[velocityToLayer[(size_t)v]];
+
+    const int zone = layer.firstZone + layer.nextZone;
+    layer.nextZone = layer.nextZone + 1 < layer.numZones ? layer.nextZone + 1 : 0;
+
+    return zones[(size_t)zone];
+}
+
 bool ExtendedSamplerSound::appliesToNote(int midiNoteNumber)
 {
     return midiNotes[midiNoteNumber];
@@ -51,38 +191,104 @@ bool ExtendedSamplerSound::appliesToChannel(int /*midiChannel*/)
     return true;
 }
 
+void ExtendedSamplerSound::setInterpolationMode(InterpolationMode mode)
+{
+    interpolationMode = mode;
+}
+
+void ExtendedSamplerSound::copySettingsFrom(const ExtendedSamplerSound& other)
+{
+    params = other.params;
+    envelopeCurve = other.envelopeCurve;
+    pitchShiftSemitones = other.pitchShiftSemitones;
+    gain = other.gain;
+    interpolationMode = other.interpolationMode;
+    filter = other.filter;
+}
+
+void ExtendedSamplerSound::copyRoundRobinFrom(const ExtendedSamplerSound& other) noexcept
+{
+    // Layers are matched by position; new layers start from their first zone.
+    const size_t numLayers = juce::jmin(layers.size(), other.layers.size());
+
+    for (size_t l = 0; l < numLayers; ++l)
+        layers[l].nextZone = other.layers[l].nextZone % layers[l].numZones;
+}
+
 void ExtendedSamplerSound::setPitchShift(int semitones)
 {
     pitchShiftSemitones = juce::Range<int>(-12, 12).clipValue(semitones); 
 }
 
 //================================================================================
-ExtendedSamplerVoice::ExtendedSamplerVoice() {}
-ExtendedSamplerVoice::~ExtendedSamplerVoice() {}
+ExtendedSamplerVoice::ExtendedSamplerVoice(const RenderKernels::SincTable& table, DiskStreamer& diskStreamer)
+    : sincTable(table),
+    streamer(diskStreamer),
+    stream(diskStreamer.getReadAhead()),
+    streamWindow(2, streamWindowFrames)
+{
+    streamer.addStream(stream);
+}
+
+ExtendedSamplerVoice::~ExtendedSamplerVoice()
+{
+    streamer.removeStream(stream);
+}
 
 bool ExtendedSamplerVoice::canPlaySound(juce::SynthesiserSound* sound)
 {
-    return dynamic_cast<const ExtendedSamplerSound*> (sound) != nullptr;
+    // SamplerSynthesiser only ever holds ExtendedSamplerSounds, so this is
+    // called on every note-on without paying for RTTI.
+    jassert(sound == nullptr || dynamic_cast<const ExtendedSamplerSound*> (sound) != nullptr);
+    return sound != nullptr;
 }
 
 void ExtendedSamplerVoice::startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* s, int /*currentPitchWheelPosition*/)
 {
-    if (auto* sound = dynamic_cast<const ExtendedSamplerSound*> (s))
+    jassert(s == nullptr || dynamic_cast<const ExtendedSamplerSound*> (s) != nullptr);
+
+    if (auto* sound = static_cast<ExtendedSamplerSound*> (s))
     {
+        const auto& zone = sound->selectZone(velocity);
+        padSound = sound;
+        sample = zone.sample.get();
+        region = &zone.region;
+
+        // A loop stays within the head, so it never needs the stream.
+        streamSource = region->isLooping ? nullptr : zone.streamSource.get();
+
         isNotePlaying = true; 
-        sourceSampleRate = sound->sourceSampleRate; 
+        sourceSampleRate = sample->getSourceSampleRate(); 
+
+        noteRatio = std::pow(2.0, (midiNoteNumber - sound->midiRootNote) / 12.0) * sourceSampleRate / getSampleRate();
+        pitchShiftSemitones = sound->pitchShiftSemitones;
+        updatePhaseIncrement();
 
-        pitchRatio = std::pow(2.0, (midiNoteNumber - sound->midiRootNote + sound->pitchShiftSemitones) / 12.0)
-            * sound->sourceSampleRate / getSampleRate();
+        phase = RenderKernels::toPhase(region->start);
+        interpolationMode = sound->interpolationMode;
 
-        sourceSamplePosition = 0.0;
+        // The head covers playback while the streamer fills the ring.
+        if (streamSource != nullptr)
+            stream.start(streamSource, sample->getHeadLength());
+        else
+            stream.stop();
         lgain = velocity;
         rgain = velocity;
 
-        adsr.setSampleRate(sound->sourceSampleRate);
-        adsr.setParameters(sound->params);
+        padGain.reset(getSampleRate(), gainRampSeconds);
+        padGain.setCurrentAndTargetValue(sound->gain);
+
+        filter = sound->filter;
+        noteVelocity = velocity;
+        filterNeedsReset = true;
+
+        // The envelope runs at the host rate; its times are independent of
+        // the rate the sample was recorded at.
+        envelope.setSampleRate(getSampleRate());
+        envelope.setCurve(sound->envelopeCurve);
+        envelope.setParameters(sound->params);
 
-        adsr.noteOn();
+        envelope.noteOn();
     }
     else
     {
@@ -95,72 +301,334 @@ void ExtendedSamplerVoice::stopNote(float /*velocity*/, bool allowTailOff)
     isNotePlaying = false; 
 
     if (allowTailOff)
+        envelope.noteOff();
+
+    if (!allowTailOff || !envelope.isActive())
     {
-        adsr.noteOff();
-    }
-    else
-    {
+        stream.stop();
         clearCurrentNote();
-        adsr.reset();
+        envelope.reset();
     }
 }
 
+void ExtendedSamplerVoice::updatePhaseIncrement() noexcept
+{
+    const double pitchRatio = noteRatio * std::pow(2.0, pitchShiftSemitones / 12.0);
+    phaseIncrement = juce::jmax<RenderKernels::Phase>(1, RenderKernels::toPhase(pitchRatio));
+}
+
 void ExtendedSamplerVoice::pitchWheelMoved(int /*newValue*/) {}
 void ExtendedSamplerVoice::controllerMoved(int /*controllerNumber*/, int /*newValue*/) {}
 
 //==============================================================================
 void ExtendedSamplerVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
 {
+    if (getCurrentlyPlayingSound() == nullptr)
+        return;
+
+    // Timed per call, which costs two counter reads against the hundreds
+    // of samples a call renders. The encoding and mode are taken first,
+    // since the note may end during the call.
+    renderCost.encoding = sample->getStorage().encoding;
+    renderCost.interpolationMode = interpolationMode;
+    renderCost.isInterpolated = phaseIncrement != phaseOne;
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    renderSamples(outputBuffer, startSample, numSamples);
+
+    renderCost.ticks += juce::Time::getHighResolutionTicks() - start;
+    renderCost.numSamples += numSamples;
+}
+
+void ExtendedSamplerVoice::renderSamples(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    using namespace RenderKernels;
 
-    if (auto* playingSound = static_cast<ExtendedSamplerSound*> (getCurrentlyPlayingSound().get()))
+    if (getCurrentlyPlayingSound() != nullptr)
     {
-        auto& data = *playingSound->data;
-        const float* const inL = data.getReadPointer(0);
-        const float* const inR = data.getNumChannels() > 1 ? data.getReadPointer(1) : nullptr;
+        // The pad's pitch and gain may have changed since the last block.
+        if (padSound->pitchShiftSemitones != pitchShiftSemitones)
+        {
+            pitchShiftSemitones = padSound->pitchShiftSemitones;
+            updatePhaseIncrement();
+        }
+
+        padGain.setTargetValue(padSound->gain);
+
+        // The filter's cutoff, resonance and modulation follow the pad too.
+        // Its mode is kept from note-on, since it decides whether the voice
+        // is rendered through the filter bank at all.
+        const auto mode = filter.mode;
+        filter = padSound->filter;
+        filter.mode = mode;
+
+        const auto& storage = sample->getStorage();
+        const bool stereoSource = storage.numChannels > 1;
+        const bool isLooping = region->isLooping;
+
+        // Chunks whose taps all fall inside storage, and before any loop
+        // crossfade, are read in place.
+        const int directEnd = (isLooping ? region->fadeStart : storage.numFrames) - maxTapsAfter;
+
+        // At the root note of a sample stored at the host rate, every
+        // fraction is zero and the frames play back one for one, so the chunk
+        // is copied (or, for float storage, used in place) instead of
+        // interpolated.
+        const bool isUnityRatio = phaseIncrement == phaseOne;
+
+        // How many samples the voice can render before its position passes
+        // the end of the region (or wraps around the loop), and how many fit
+        // in one window, worked out once for the block and at each wrap
+        // rather than tested per sample. Chunks are split at the wrap.
+        const Phase endPhase = toPhase(juce::jmin(region->end, sample->getAudibleLength()));
+        const Phase loopEndPhase = toPhase(region->loopEnd);
+        const Phase loopLength = toPhase(region->loopEnd - region->loopStart);
+
+        auto samplesUntilWrap = [&]
+        {
+            return (juce::int64)((loopEndPhase - phase + phaseIncrement - 1) / phaseIncrement);
+        };
+
+        juce::int64 samplesUntilEnd = isLooping ? samplesUntilWrap()
+                                    : phase > endPhase ? 1 : (juce::int64)((endPhase - phase) / phaseIncrement) + 1;
+        const int maxChunkSamples = (int)juce::jmin<Phase>(chunkSize, (toPhase(maxChunkSpan - 1) / phaseIncrement) + 1);
 
         float* outL = outputBuffer.getWritePointer(0, startSample);
         float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer(1, startSample) : nullptr;
 
-        while (--numSamples >= 0)
+        alignas(alignment) float left[chunkSize];
+        alignas(alignment) float right[chunkSize];
+        alignas(alignment) float gainL[chunkSize];
+        alignas(alignment) float gainR[chunkSize];
+
+        // A released voice whose output stays below -120 dB for a whole
+        // block is stopped. A released envelope only falls, so its first
+        // gain in a chunk bounds the rest; the pad gain may still be ramping
+        // up, so it is bounded by the larger of its value and its target.
+        const bool isReleased = isPlayingButReleased();
+        const bool isWholeBlock = startSample == 0 && numSamples == outputBuffer.getNumSamples();
+        float blockPeak = 0.0f;
+
+        while (numSamples > 0)
         {
-            auto pos = (int)sourceSamplePosition;
-            auto alpha = (float)(sourceSamplePosition - pos);
-            auto invAlpha = 1.0f - alpha;
+            int numThisChunk = juce::jmin(numSamples, maxChunkSamples);
+            bool reachedEnd = false, wraps = false;
 
-            // just using a very simple linear interpolation here..
-            float l = (inL[pos] * invAlpha + inL[pos + 1] * alpha);
-            float r = (inR != nullptr) ? (inR[pos] * invAlpha + inR[pos + 1] * alpha) : l;
+            if (numThisChunk >= samplesUntilEnd)
+            {
+                numThisChunk = (int)samplesUntilEnd;
+                reachedEnd = !isLooping;
+                wraps = isLooping;
+            }
+
+            PhaseRamp ramp { phase, phaseIncrement };
+            phase += phaseIncrement * (Phase)numThisChunk;
+            samplesUntilEnd -= numThisChunk;
+
+            // A release that has dropped below the silence threshold ends the
+            // voice early instead of rendering inaudible samples.
+            const int numAudible = envelope.render(gainL, numThisChunk);
+
+            if (numAudible < numThisChunk)
+            {
+                numThisChunk = numAudible;
+                reachedEnd = true;
+            }
 
-            auto envelopeValue = adsr.getNextSample();
+            const float envelopeStart = numThisChunk > 0 ? gainL[0] : 0.0f;
+            const float padGainBound = juce::jmax(padGain.getCurrentValue(), padGain.getTargetValue());
+            float chunkGain = padGain.getCurrentValue();
 
-            l *= lgain * envelopeValue;
-            r *= rgain * envelopeValue;
+            if (padGain.isSmoothing())
+            {
+                for (int i = 0; i < numThisChunk; ++i)
+                    gainL[i] *= padGain.getNextValue();
+
+                chunkGain = 1.0f;
+            }
+
+            const float* srcL = left;
+            const float* srcR = right;
+
+            if (numThisChunk > 0 && getIndex(ramp.at(numThisChunk - 1)) >= directEnd)
+            {
+                fetchWindow(ramp, numThisChunk);
+
+                if (isUnityRatio)
+                {
+                    srcL = streamWindow.getReadPointer(0, getIndex(ramp.start));
+                    srcR = stereoSource ? streamWindow.getReadPointer(1, getIndex(ramp.start)) : nullptr;
+                }
+                else
+                {
+                    interpolate(streamWindow.getReadPointer(0), ramp, left, numThisChunk);
+
+                    if (stereoSource)
+                        interpolate(streamWindow.getReadPointer(1), ramp, right, numThisChunk);
+                }
+            }
+            else if (isUnityRatio)
+            {
+                srcL = storage.getFrames(0, getIndex(ramp.start), numThisChunk, left);
+
+                if (stereoSource)
+                    srcR = storage.getFrames(1, getIndex(ramp.start), numThisChunk, right);
+            }
+            else
+            {
+                storage.visit(0, [&](auto src) { interpolate(src, ramp, left, numThisChunk); });
+
+                if (stereoSource)
+                    storage.visit(1, [&](auto src) { interpolate(src, ramp, right, numThisChunk); });
+            }
+
+            if (!stereoSource)
+                srcR = srcL;
 
             if (outR != nullptr)
             {
-                *outL++ += l;
-                *outR++ += r;
+                juce::FloatVectorOperations::multiply(gainR, gainL, rgain * storage.scale * chunkGain, numThisChunk);
+                juce::FloatVectorOperations::multiply(gainL, lgain * storage.scale * chunkGain, numThisChunk);
+
+                juce::FloatVectorOperations::addWithMultiply(outL, srcL, gainL, numThisChunk);
+                juce::FloatVectorOperations::addWithMultiply(outR, srcR, gainR, numThisChunk);
+                outR += numThisChunk;
             }
             else
             {
-                *outL++ += (l + r) * 0.5f;
+                juce::FloatVectorOperations::multiply(gainR, gainL, rgain * storage.scale * chunkGain * 0.5f, numThisChunk);
+                juce::FloatVectorOperations::multiply(gainL, lgain * storage.scale * chunkGain * 0.5f, numThisChunk);
+
+                juce::FloatVectorOperations::addWithMultiply(outL, srcL, gainL, numThisChunk);
+                juce::FloatVectorOperations::addWithMultiply(outL, srcR, gainR, numThisChunk);
             }
 
-            sourceSamplePosition += pitchRatio;
+            if (isReleased && numThisChunk > 0)
+            {
+                auto magnitude = [numThisChunk](const float* src)
+                {
+                    const auto range = juce::FloatVectorOperations::findMinAndMax(src, numThisChunk);
+                    return juce::jmax(-range.getStart(), range.getEnd());
+                };
+
+                const float bound = envelopeStart * padGainBound * storage.scale * (outR != nullptr ? 1.0f : 0.5f);
 
-            if (sourceSamplePosition > playingSound->length)
+                blockPeak = juce::jmax(blockPeak, magnitude(srcL) * bound * lgain);
+
+                if (stereoSource)
+                    blockPeak = juce::jmax(blockPeak, magnitude(srcR) * bound * rgain);
+            }
+
+            outL += numThisChunk;
+            numSamples -= numThisChunk;
+
+            if (reachedEnd)
             {
                 stopNote(0.0f, false);
-                break;
+                return;
+            }
+
+            if (wraps)
+            {
+                // A step longer than the loop can pass over it more than once.
+                while (phase >= loopEndPhase)
+                    phase -= loopLength;
+
+                samplesUntilEnd = samplesUntilWrap();
             }
         }
+
+        if (isReleased && isWholeBlock && blockPeak < SampleData::silenceLevel)
+            stopNote(0.0f, false);
+    }
+}
+
+template <typename Source>
+void ExtendedSamplerVoice::interpolate(Source src, RenderKernels::PhaseRamp ramp, float* dest, int num) const noexcept
+{
+    switch (interpolationMode)
+    {
+    case InterpolationMode::hermite:
+        RenderKernels::interpolateHermite(src, ramp, dest, num);
+        break;
+
+    case InterpolationMode::sinc:
+        RenderKernels::interpolateSinc(sincTable, src, ramp, dest, num);
+        break;
+
+    case InterpolationMode::linear:
+    default:
+        RenderKernels::interpolateLinear(src, ramp, dest, num);
+        break;
+    }
+}
+
+void ExtendedSamplerVoice::fetchWindow(RenderKernels::PhaseRamp& ramp, int num) noexcept
+{
+    using namespace RenderKernels;
+
+    const auto& storage = sample->getStorage();
+    const int lastIndex = getIndex(ramp.at(num - 1));
+    const int first = juce::jmax(0, getIndex(ramp.start) - maxTapsBefore);
+    const int numFrames = lastIndex + maxTapsAfter + 1 - first;
+    jassert(numFrames <= streamWindow.getNumSamples());
+
+    const int storageEnd = region->isLooping ? region->fadeStart : storage.numFrames;
+    const int numFromStorage = juce::jlimit(0, numFrames, storageEnd - first);
+    const int numRemaining = numFrames - numFromStorage;
+    float* dest[2] {};
+
+    for (int ch = 0; ch < storage.numChannels; ++ch)
+    {
+        storage.readFrames(ch, first, numFromStorage, streamWindow.getWritePointer(ch));
+        dest[ch] = streamWindow.getWritePointer(ch, numFromStorage);
+    }
+
+    if (numRemaining > 0)
+    {
+        if (region->isLooping)
+        {
+            // Chunks end before loopEnd, so the taps stay inside the tail.
+            const int tailStart = first + numFromStorage - region->fadeStart;
+            jassert(tailStart + numRemaining <= region->loopTail.getNumSamples());
+
+            for (int ch = 0; ch < storage.numChannels; ++ch)
+                juce::FloatVectorOperations::copy(dest[ch], region->loopTail.getReadPointer(ch, tailStart), numRemaining);
+        }
+        else if (streamSource != nullptr)
+        {
+            stream.read(first + numFromStorage, numRemaining, dest, storage.numChannels);
+
+            // The next chunk starts no earlier than the last position of this one.
+            stream.release(lastIndex - maxTapsBefore);
+        }
+        else
+        {
+            for (int ch = 0; ch < storage.numChannels; ++ch)
+                juce::FloatVectorOperations::clear(dest[ch], numRemaining);
+        }
     }
+
+    ramp.start -= toPhase(first);
+}
+
+VoiceFilterBank::Lane ExtendedSamplerVoice::takeFilterLane() noexcept
+{
+    VoiceFilterBank::Lane lane;
+    lane.slot = filterSlot;
+    lane.reset = std::exchange(filterNeedsReset, false);
+    lane.mode = filter.mode;
+    lane.resonance = filter.resonance;
+
+    const float octaves = filter.envelopeAmount * envelope.getCurrentLevel() + filter.velocityAmount * noteVelocity;
+    lane.cutoff = filter.cutoff * std::exp2(octaves);
+    return lane;
 }
 
 double ExtendedSamplerVoice::getSourceSamplePosition()
 {
     if (isNotePlaying)
-        return sourceSamplePosition;
+        return RenderKernels::toFrames(phase);
     else
         return 0; 
 }
@@ -170,4 +638,296 @@ double ExtendedSamplerVoice::getSouceSampleRate()
     return sourceSampleRate; 
 }
 
+//================================================================================
+SamplerSynthesiser::SamplerSynthesiser()
+{
+    setNoteStealingEnabled(true);
+
+    // Adding a sound on the audio thread must not grow the array. Each pad
+    // holds at most one sound, and a replaced one is removed first.
+    sounds.ensureStorageAllocated(maxPads);
+}
+
+SamplerSynthesiser::~SamplerSynthesiser()
+{
+    // Voices refer to the sinc table and the streamer, which are destroyed
+    // before the base class would delete the voices.
+    clearVoices();
+}
+
+void SamplerSynthesiser::setVoiceCount(int numVoicesToUse)
+{
+    const int target = juce::jlimit(minNumVoices, maxNumVoices, numVoicesToUse);
+
+    while (getNumVoices() > target)
+        removeVoice(getNumVoices() - 1);
+
+    while (getNumVoices() < target)
+    {
+        auto* voice = new ExtendedSamplerVoice(sincTable, streamer);
+        voice->setFilterSlot(getNumVoices());
+        addVoice(voice);
+    }
+}
+
+void SamplerSynthesiser::setNumRenderThreads(int numThreads)
+{
+    numRenderThreads = juce::jlimit(0, VoiceRenderPool::maxThreads, numThreads);
+    renderPool->reserveThreads(numRenderThreads);
+}
+
+void SamplerSynthesiser::prepareRenderThreads(int numChannels, int maxBlockSize)
+{
+    renderPool->prepare(numChannels, maxBlockSize);
+
+    // Only this instance's share of the pool needs filter contexts.
+    filterBank.prepare(getSampleRate(), numRenderThreads + 1, numChannels, maxBlockSize);
+}
+
+void SamplerSynthesiser::setPadSound(ExtendedSamplerSound::Ptr sound)
+{
+    jassert(sound != nullptr && juce::isPositiveAndBelow(sound->getId(), maxPads));
+
+    const juce::ScopedLock sl(lock);
+    auto& slot = padSounds[(size_t)sound->getId()];
+    ExtendedSamplerSound::Ptr previous = slot;
+
+    // The old sound is removed before the new one is added, so the array
+    // never holds more than maxPads sounds. previous keeps it alive until
+    // the release pool, which also refers to it, lets it go.
+    if (previous != nullptr)
+        sounds.removeObject(previous.get());
+
+    slot = sound.get();
+    sounds.add(sound);
+
+    // The old sound's notes may now fall back to other pads; the new
+    // sound's notes gain it as a layer.
+    if (previous != nullptr)
+        updateNoteSounds(*previous);
+
+    updateNoteSounds(*sound);
+}
+
+void SamplerSynthesiser::clearPadSound(int padId)
+{
+    if (!juce::isPositiveAndBelow(padId, maxPads))
+        return;
+
+    const juce::ScopedLock sl(lock);
+    auto& slot = padSounds[(size_t)padId];
+
+    if (slot == nullptr)
+        return;
+
+    ExtendedSamplerSound::Ptr previous = slot;
+    slot = nullptr;
+    sounds.removeObject(previous.get());
+    updateNoteSounds(*previous);
+}
+
+void SamplerSynthesiser::updateNoteSounds(ExtendedSamplerSound& sound)
+{
+    for (int note = 0; note < (int)noteSounds.size(); ++note)
+    {
+        if (!sound.appliesToNote(note))
+            continue;
+
+        auto& entry = noteSounds[(size_t)note];
+        entry.numSounds = 0;
 
+        for (auto* padSound : padSounds)
+        {
+            if (padSound == nullptr || !padSound->appliesToNote(note))
+                continue;
+
+            // More layers than this on one note are not played.
+            jassert(entry.numSounds < maxSoundsPerNote);
+
+            if (entry.numSounds < maxSoundsPerNote)
+                entry.sounds[(size_t)entry.numSounds++] = padSound;
+        }
+    }
+}
+
+void SamplerSynthesiser::noteOn(int midiChannel, int midiNoteNumber, float velocity)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (!juce::isPositiveAndBelow(midiNoteNumber, (int)noteSounds.size()))
+        return;
+
+    const auto& entry = noteSounds[(size_t)midiNoteNumber];
+
+    if (entry.numSounds == 0)
+        return;
+
+    // Same retrigger behaviour as juce::Synthesiser::noteOn: a repeated
+    // note on the same channel releases the voices already playing it.
+    // Done once, before any layer starts, so the layers do not release
+    // one another.
+    for (auto* voice : voices)
+        if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isPlayingChannel(midiChannel))
+            stopVoice(voice, 1.0f, true);
+
+    for (int i = 0; i < entry.numSounds; ++i)
+    {
+        auto* sound = entry.sounds[(size_t)i];
+        auto* voice = findFreeVoice(sound, midiChannel, midiNoteNumber, isNoteStealingEnabled());
+
+        if (voice != nullptr && voice->isVoiceActive())
+            ++numSteals;
+
+        startVoice(voice, sound, midiChannel, midiNoteNumber, velocity);
+    }
+}
+
+juce::SynthesiserVoice* SamplerSynthesiser::findVoiceToSteal(juce::SynthesiserSound* soundToPlay,
+    int /*midiChannel*/, int /*midiNoteNumber*/) const
+{
+    jassert(!voices.isEmpty());
+
+    juce::SynthesiserVoice* samePad = nullptr;
+    juce::SynthesiserVoice* quietestReleased = nullptr;
+    juce::SynthesiserVoice* oldest = nullptr;
+    float quietestLevel = std::numeric_limits<float>::max();
+
+    for (auto* v : voices)
+    {
+        if (v->getCurrentlyPlayingSound().get() == soundToPlay)
+        {
+            if (samePad == nullptr || v->wasStartedBefore(*samePad))
+                samePad = v;
+        }
+
+        if (v->isPlayingButReleased())
+        {
+            const float level = static_cast<ExtendedSamplerVoice*>(v)->getEnvelopeLevel();
+
+            if (level < quietestLevel)
+            {
+                quietestLevel = level;
+                quietestReleased = v;
+            }
+        }
+
+        if (oldest == nullptr || v->wasStartedBefore(*oldest))
+            oldest = v;
+    }
+
+    if (samePad != nullptr)
+        return samePad;
+
+    if (quietestReleased != nullptr)
+        return quietestReleased;
+
+    return oldest;
+}
+
+void SamplerSynthesiser::renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // Only sounding voices are rendered, so the cost stays proportional to
+    // their number rather than the size of the pool.
+    int numToRender = 0, numFiltered = 0;
+
+    for (auto* v : voices)
+    {
+        if (!v->isVoiceActive())
+            continue;
+
+        auto* voice = static_cast<ExtendedSamplerVoice*> (v);
+        ++numToRender;
+
+        // Filtered voices fill renderOrder from the front, the rest from
+        // the back, so the groups are contiguous.
+        if (voice->isFiltered() && filterBank.isPrepared())
+            renderOrder[(size_t)numFiltered++] = voice;
+        else
+            renderOrder[(size_t)(maxNumVoices - (numToRender - numFiltered))] = voice;
+    }
+
+    int numItems = 0;
+
+    for (int first = 0; first < numFiltered; first += VoiceFilterBank::numLanes)
+        renderItems[(size_t)numItems++] = { first, juce::jmin(VoiceFilterBank::numLanes, numFiltered - first), true };
+
+    for (int i = maxNumVoices - (numToRender - numFiltered); i < maxNumVoices; ++i)
+        renderItems[(size_t)numItems++] = { i, 1, false };
+
+    if (!renderPool->render(*this, numRenderThreads, numItems, numToRender, buffer, startSample, numSamples))
+        for (int i = 0; i < numItems; ++i)
+            renderItem(i, 0, buffer, startSample, numSamples);
+
+    int numActive = 0;
+
+    for (int i = 0; i < numItems; ++i)
+    {
+        for (int v = 0; v < renderItems[(size_t)i].numVoices; ++v)
+        {
+            auto* voice = renderOrder[(size_t)(renderItems[(size_t)i].first + v)];
+            numActive += voice->isVoiceActive() ? 1 : 0;
+
+            // Single writer, so a relaxed load and store rather than a
+            // read-modify-write.
+            auto add = [](std::atomic<juce::int64>& counter, juce::int64 amount)
+            {
+                counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+            };
+
+            const auto cost = voice->takeRenderCost();
+            add(renderTicks[(size_t)cost.encoding], cost.ticks);
+            add(renderedSamples[(size_t)cost.encoding], cost.numSamples);
+
+            if (cost.isInterpolated)
+            {
+                add(interpolationTicks[(size_t)cost.interpolationMode], cost.ticks);
+                add(interpolatedSamples[(size_t)cost.interpolationMode], cost.numSamples);
+            }
+        }
+    }
+
+    numActiveVoices = numActive;
+}
+
+void SamplerSynthesiser::renderItem(int item, int context, juce::AudioBuffer<float>& target,
+    int startSample, int numSamples) noexcept
+{
+    const auto& toRender = renderItems[(size_t)item];
+    auto* const* group = renderOrder.data() + toRender.first;
+
+    if (toRender.isFiltered)
+        renderFilteredGroup(group, toRender.numVoices, context, target, startSample, numSamples);
+    else
+        group[0]->renderNextBlock(target, startSample, numSamples);
+}
+
+void SamplerSynthesiser::renderFilteredGroup(ExtendedSamplerVoice* const* group, int numInGroup, int context,
+    juce::AudioBuffer<float>& target, int startSample, int numSamples) noexcept
+{
+    // Voices see the same buffer geometry as when rendering straight into
+    // the output, unless the block is larger than the lane buffers.
+    const int capacity = filterBank.getMaxBlockSize();
+    const bool fits = target.getNumSamples() <= capacity;
+
+    for (int done = 0; done < numSamples;)
+    {
+        const int numThis = fits ? numSamples : juce::jmin(capacity, numSamples - done);
+        const int laneStart = fits ? startSample : 0;
+        VoiceFilterBank::Lane lanes[VoiceFilterBank::numLanes];
+
+        for (int l = 0; l < numInGroup; ++l)
+        {
+            auto& laneBuffer = filterBank.getLaneBuffer(context, l);
+            juce::AudioBuffer<float> view(laneBuffer.getArrayOfWritePointers(),
+                juce::jmin(target.getNumChannels(), laneBuffer.getNumChannels()),
+                fits ? target.getNumSamples() : numThis);
+
+            view.clear(laneStart, numThis);
+            group[l]->renderNextBlock(view, laneStart, numThis);
+            lanes[l] = group[l]->takeFilterLane();
+        }
+
+        filterBank.process(context, lanes, numInGroup, target, startSample + done, laneStart, numThis);
+        done += numThis;
+    }
+}
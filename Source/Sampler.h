@@ -10,27 +10,119 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <utility>
+#include "DiskStreamer.h"
+#include "Envelope.h"
+#include "Model.h"
+#include "RenderKernels.h"
+#include "SamplePool.h"
+#include "SampleStorage.h"
+#include "VoiceFilter.h"
+#include "VoiceRenderPool.h"
+
+// A file to play on a pad for velocities lowVelocity..highVelocity (1-127).
+// Zones with the same range form one velocity layer and take turns, in the
+// order given, as round-robin alternatives.
+struct SampleZone
+{
+    juce::File file;
+    int lowVelocity = 1;
+    int highVelocity = 127;
+
+    // Encoded audio from a saved state, played instead of the file when set.
+    std::shared_ptr<const juce::MemoryBlock> embeddedAudio;
+};
 
 //=====================================================================
+// One pad. Holds a zone per loaded sample, grouped into velocity layers.
+// The layer for a note is found through a 128-entry velocity table built
+// up front, and each layer cycles through its zones round-robin.
+//
+// The pad's SampleRegion is resolved to frames for each zone when the
+// sound is built, and a loop's crossfade is rendered into a buffer then,
+// so voices only ever read one position at a time.
 class ExtendedSamplerSound : public juce::SynthesiserSound
 {
 public:
+    using Ptr = juce::ReferenceCountedObjectPtr<ExtendedSamplerSound>;
+
+    // A zone's SampleRegion in frames. Filled in by the sound.
+    struct PlayRegion
+    {
+        int start = 0, end = 0;
+
+        // Only set for loops of at least minLoopFrames. Streamed zones loop
+        // only if the loop lies within their preloaded head.
+        bool isLooping = false;
+        int loopStart = 0, loopEnd = 0;
+
+        // Frames fadeStart..loopEnd with the crossfade applied, followed by
+        // the first few frames of the loop, so interpolation taps read
+        // across the wrap as one run.
+        int fadeStart = 0;
+        juce::AudioBuffer<float> loopTail;
+    };
+
+    static constexpr int minLoopFrames = 16;
 
-    ExtendedSamplerSound(const juce::String& name,
-        juce::AudioFormatReader& source,
+    struct Zone
+    {
+        // Frames, possibly shared with other sounds through the SamplePool.
+        // If streamSource is set, sample only holds the head.
+        SampleData::Ptr sample;
+        StreamSource::Ptr streamSource;
+        int lowVelocity = 1;
+        int highVelocity = 127;
+        PlayRegion region;
+    };
+
+    // zones must not be empty. Velocities not covered by any zone play the
+    // nearest layer, so a pad whose layers are still loading stays playable.
+    ExtendedSamplerSound(int padId,
+        const juce::String& name,
+        std::vector<Zone> zones,
         const juce::BigInteger& midiNotes,
         int midiNoteForNormalPitch,
         double attackTimeSecs,
         double releaseTimeSecs,
-        double maxSampleLengthSeconds);
+        const SampleRegion& region = {});
 
     ~ExtendedSamplerSound() override;
 
+    // A copy of this sound that plays another region of the same zones.
+    // Message thread; settings are left for the caller to copy over.
+    Ptr withRegion(const SampleRegion&) const;
+    const SampleRegion& getRegion() const noexcept { return region; }
+
+    int getId() const noexcept { return id; }
     const juce::String& getName() const noexcept { return name; }
-    juce::AudioBuffer<float>* getAudioData() const noexcept { return data.get(); }
+
+    int getNumZones() const noexcept { return static_cast<int>(zones.size()); }
+    const Zone& getZone(int index) const noexcept { return zones[(size_t)index]; }
+    int getNumLayers() const noexcept { return static_cast<int>(layers.size()); }
+
+    // Audio thread. Picks the zone for a note and advances its layer's
+    // round-robin position.
+    const Zone& selectZone(float velocity) noexcept;
 
     void setEnvelopeParameters(juce::ADSR::Parameters parametersToUse) { params = parametersToUse; }
+    void setEnvelopeCurve(BlockEnvelope::Curve curveToUse) { envelopeCurve = curveToUse; }
     void setPitchShift(int); 
+    void setInterpolationMode(InterpolationMode);
+    void setFilterParameters(const FilterParameters& parametersToUse) { filter = parametersToUse; }
+    // Linear. Sounding voices glide to a new gain; pitch changes apply at
+    // their next block.
+    void setGain(float newGain) noexcept { gain = newGain; }
+
+    // Takes over the envelope, pitch, gain, interpolation and filter of a
+    // sound this one replaces.
+    void copySettingsFrom(const ExtendedSamplerSound&);
+
+    // Audio thread. Carries on each layer's round-robin from where the sound
+    // this one replaces had got to.
+    void copyRoundRobinFrom(const ExtendedSamplerSound&) noexcept;
 
     bool appliesToNote(int midiNoteNumber) override;
     bool appliesToChannel(int midiChannel) override;
@@ -40,14 +132,28 @@ private:
     //==============================================================================
     friend class ExtendedSamplerVoice;
 
+    struct Layer
+    {
+        int firstZone = 0;
+        int numZones = 0;
+        int nextZone = 0;    // Round-robin position, audio thread only
+    };
+
+    int id = -1;
     juce::String name;
-    std::unique_ptr<juce::AudioBuffer<float>> data;
-    double sourceSampleRate;
+    std::vector<Zone> zones;    // Grouped by layer
+    std::vector<Layer> layers;
+    std::array<juce::uint8, 128> velocityToLayer {};
     juce::BigInteger midiNotes;
-    int length = 0, midiRootNote = 0;
+    int midiRootNote = 0;
+    SampleRegion region;
 
     int pitchShiftSemitones = 0; 
+    float gain = 1.0f;
+    InterpolationMode interpolationMode = InterpolationMode::linear;
     juce::ADSR::Parameters params;
+    BlockEnvelope::Curve envelopeCurve = BlockEnvelope::Curve::linear;
+    FilterParameters filter;
 
     JUCE_LEAK_DETECTOR(ExtendedSamplerSound)
 };
@@ -55,7 +161,7 @@ private:
 class ExtendedSamplerVoice : public juce::SynthesiserVoice
 {
 public:
-    ExtendedSamplerVoice();
+    ExtendedSamplerVoice(const RenderKernels::SincTable&, DiskStreamer&);
     ~ExtendedSamplerVoice() override;
 
     //==============================================================================
@@ -73,16 +179,226 @@ public:
     //Extended functionality
     double getSourceSamplePosition();
     double getSouceSampleRate(); 
+    float getEnvelopeLevel() const noexcept { return envelope.getCurrentLevel(); }
+    int getPadId() const noexcept { return padSound != nullptr ? padSound->getId() : -1; }
+    // Seconds from the start of the file, including while the note releases.
+    double getPositionSeconds() const noexcept { return sourceSampleRate > 0 ? RenderKernels::toFrames(phase) / sourceSampleRate : 0.0; }
+
+    // Whether the pad had a filter when the note started. Voices without
+    // one are rendered straight into the output.
+    bool isFiltered() const noexcept { return filter.mode != FilterMode::off; }
+
+    // The voice's lane in a filtered group, with the cutoff for the end of
+    // the block just rendered. Audio thread; clears the voice's reset flag.
+    VoiceFilterBank::Lane takeFilterLane() noexcept;
+
+    // Where the voice's filter state lives in the VoiceFilterBank.
+    void setFilterSlot(int slot) noexcept { filterSlot = slot; }
+
+    // Audio thread. The time spent rendering since the last call, the
+    // samples rendered in it, the encoding they were read from and whether
+    // they were interpolated. Clears the voice's counts.
+    struct RenderCost
+    {
+        juce::int64 ticks = 0;
+        juce::int64 numSamples = 0;
+        SampleStorage::Encoding encoding = SampleStorage::Encoding::float32;
+        InterpolationMode interpolationMode = InterpolationMode::linear;
+        bool isInterpolated = false;
+    };
+
+    RenderCost takeRenderCost() noexcept { return std::exchange(renderCost, {}); }
 
 private:
+    void renderSamples(juce::AudioBuffer<float>&, int startSample, int numSamples);
+
+    template <typename Source>
+    void interpolate(Source src, RenderKernels::PhaseRamp, float* dest, int num) const noexcept;
+
+    // Gathers the frames a chunk needs into streamWindow, from the zone's
+    // storage and then the loop tail, the stream, or silence past the end,
+    // and rebases ramp to point into it. Used for chunks that reach past the
+    // frames the kernels may address directly.
+    void fetchWindow(RenderKernels::PhaseRamp& ramp, int num) noexcept;
+
+    void updatePhaseIncrement() noexcept;
+
+    // Largest span of source frames a single chunk may cover.
+    static constexpr int streamWindowFrames = 4096;
+    static constexpr int maxChunkSpan = streamWindowFrames - RenderKernels::maxTapsBefore - RenderKernels::maxTapsAfter - 1;
+
     //==============================================================================
-    double pitchRatio = 0;
-    double sourceSamplePosition = 0;
+    const RenderKernels::SincTable& sincTable;
+    DiskStreamer& streamer;
+    StreamBuffer stream;
+    juce::AudioBuffer<float> streamWindow;
+    InterpolationMode interpolationMode = InterpolationMode::linear;
+
+    // The zone being played. Kept alive by the sound, which the base class
+    // holds while the note plays.
+    const ExtendedSamplerSound* padSound = nullptr;
+    const SampleData* sample = nullptr;
+    StreamSource* streamSource = nullptr;
+    const ExtendedSamplerSound::PlayRegion* region = nullptr;
+
+    // 32.32 fixed-point position in the sample, and its step per output sample.
+    RenderKernels::Phase phase = 0;
+    RenderKernels::Phase phaseIncrement = RenderKernels::phaseOne;
     double sourceSampleRate = 0; 
+    double noteRatio = 1.0;    // Playback ratio before the pad's pitch shift
+    int pitchShiftSemitones = 0;
     float lgain = 0, rgain = 0;
 
-    juce::ADSR adsr;
+    // Ramps only while the pad's gain is changing; otherwise the gain is
+    // folded into the per-chunk channel gains.
+    juce::SmoothedValue<float> padGain;
+    static constexpr double gainRampSeconds = 0.02;
+
+    RenderCost renderCost;
+
+    FilterParameters filter;
+    float noteVelocity = 0.0f;
+    int filterSlot = 0;
+    bool filterNeedsReset = false;
+
+    BlockEnvelope envelope;
 
     bool isNotePlaying = false; 
     JUCE_LEAK_DETECTOR(ExtendedSamplerVoice)
-};
\ No newline at end of file
+};
+
+//=====================================================================
+// Synthesiser with a fixed pool of ExtendedSamplerVoices. The pool is
+// (re)allocated from prepareToPlay so the audio thread never allocates
+// voices, and findVoiceToSteal is replaced with a single pass that
+// prefers, in order: a voice already playing the same pad, the quietest
+// released voice, and finally the oldest voice.
+//
+// Sounds are indexed by pad id and by MIDI note, so parameter updates and
+// note-ons are constant-time lookups. Every pad mapped to a note plays on
+// it, layered in pad order, up to maxSoundsPerNote. Use setPadSound rather
+// than addSound/removeSound, which would bypass those tables.
+class SamplerSynthesiser : public juce::Synthesiser,
+                           private VoiceRenderPool::Renderer
+{
+public:
+    static constexpr int minNumVoices = 16;
+    static constexpr int maxNumVoices = 256;
+    static_assert(maxNumVoices <= VoiceFilterBank::maxSlots, "Every voice needs a filter slot");
+    static constexpr int defaultNumVoices = 32;
+    static constexpr int maxPads = 128;
+    static constexpr int maxSoundsPerNote = 16;
+
+    SamplerSynthesiser();
+    ~SamplerSynthesiser() override;
+
+    // Must not be called concurrently with rendering (e.g. from prepareToPlay).
+    void setVoiceCount(int numVoicesToUse);
+    void setStreamReadAhead(int numFrames) { streamer.setReadAhead(numFrames); }
+
+    // Worker threads, from the process-wide pool, that help render voices;
+    // 0 renders everything on the audio thread. Blocks with too few voices
+    // are rendered serially anyway. Neither may be called concurrently with
+    // rendering.
+    void setNumRenderThreads(int numThreads);
+
+    // Also prepares the voice filters, at the current playback rate.
+    void prepareRenderThreads(int numChannels, int maxBlockSize);
+
+    DiskStreamer& getStreamer() noexcept { return streamer; }
+
+    // Voices still sounding after the last rendered block. Voices only start
+    // while a block is rendered, so zero means the synth stays silent until
+    // it is given MIDI.
+    int getNumActiveVoices() const noexcept { return numActiveVoices; }
+
+    // Audio thread. Voices taken from another note since construction.
+    int getNumSteals() const noexcept { return numSteals; }
+
+    // Any thread. Ticks spent rendering voices that read from the given
+    // encoding since construction, and the voice samples they rendered.
+    std::pair<juce::int64, juce::int64> getRenderCost(SampleStorage::Encoding encoding) const noexcept
+    {
+        return { renderTicks[(size_t)encoding].load(std::memory_order_relaxed),
+                 renderedSamples[(size_t)encoding].load(std::memory_order_relaxed) };
+    }
+
+    // Any thread. The same, for voices that interpolated with the given mode.
+    std::pair<juce::int64, juce::int64> getRenderCost(InterpolationMode mode) const noexcept
+    {
+        return { interpolationTicks[(size_t)mode].load(std::memory_order_relaxed),
+                 interpolatedSamples[(size_t)mode].load(std::memory_order_relaxed) };
+    }
+
+    // Replaces the sound for the pad given by sound->getId(). The previous
+    // sound is released but keeps playing in any voice that still uses it.
+    void setPadSound(ExtendedSamplerSound::Ptr sound);
+    // Removes the pad's sound. Like a replaced sound, it plays on in any
+    // voice that still uses it.
+    void clearPadSound(int padId);
+
+    ExtendedSamplerSound* getPadSound(int padId) const noexcept
+    {
+        return juce::isPositiveAndBelow(padId, maxPads) ? padSounds[(size_t)padId] : nullptr;
+    }
+
+    void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
+
+protected:
+    juce::SynthesiserVoice* findVoiceToSteal(juce::SynthesiserSound* soundToPlay,
+        int midiChannel, int midiNoteNumber) const override;
+
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+
+private:
+    // A single voice, or up to VoiceFilterBank::numLanes filtered voices
+    // rendered and filtered together. Indexes renderOrder.
+    struct RenderItem
+    {
+        int first = 0;
+        int numVoices = 1;
+        bool isFiltered = false;
+    };
+
+    void renderItem(int item, int context, juce::AudioBuffer<float>& target,
+        int startSample, int numSamples) noexcept override;
+    void renderFilteredGroup(ExtendedSamplerVoice* const* group, int numInGroup, int context,
+        juce::AudioBuffer<float>& target, int startSample, int numSamples) noexcept;
+
+    // Shared by all voices; built once per plugin instance.
+    RenderKernels::SincTable sincTable;
+    DiskStreamer streamer;
+
+    juce::SharedResourcePointer<VoiceRenderPool> renderPool;
+    int numRenderThreads = 0;
+    VoiceFilterBank filterBank;
+
+    // Rebuilt each block: filtered voices first, grouped, then the rest.
+    std::array<ExtendedSamplerVoice*, maxNumVoices> renderOrder {};
+    std::array<RenderItem, maxNumVoices> renderItems {};
+
+    // The pads mapped to a note, in pad order.
+    struct NoteSounds
+    {
+        std::array<ExtendedSamplerSound*, maxSoundsPerNote> sounds {};
+        int numSounds = 0;
+    };
+
+    // Rebuilds the entry of every note the sound is mapped to.
+    void updateNoteSounds(ExtendedSamplerSound& sound);
+
+    // Non-owning views of the sounds array, maintained by setPadSound.
+    std::array<ExtendedSamplerSound*, maxPads> padSounds {};
+    std::array<NoteSounds, 128> noteSounds {};
+
+    int numActiveVoices = 0;
+    int numSteals = 0;
+
+    // Written by the audio thread only.
+    std::array<std::atomic<juce::int64>, SampleStorage::numEncodings> renderTicks {};
+    std::array<std::atomic<juce::int64>, SampleStorage::numEncodings> renderedSamples {};
+    std::array<std::atomic<juce::int64>, numInterpolationModes> interpolationTicks {};
+    std::array<std::atomic<juce::int64>, numInterpolationModes> interpolatedSamples {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SamplerSynthesiser)
+};
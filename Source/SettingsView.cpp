@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    SettingsView.cpp
+    Created: 18 Oct 2026 4:12:36am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "SettingsView.h"
+#include "VoiceRenderPool.h"
+
+SettingsView::SettingsView(const DataModel& dm)
+    :mDataModel(dm)
+{
+    mDataModel.addListener(*this);
+
+    mRenderThreadsLabel.setText("Render Threads", juce::dontSendNotification);
+    mRenderThreadsLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(mRenderThreadsLabel);
+
+    // Item ids are thread counts + 1, since ComboBox reserves 0.
+    mRenderThreadsSelect.addItem("Off", 1);
+
+    for (int threads = 1; threads <= VoiceRenderPool::maxThreads; ++threads)
+        mRenderThreadsSelect.addItem(juce::String(threads), threads + 1);
+
+    mRenderThreadsSelect.onChange = [this] { mDataModel.setRenderThreads(mRenderThreadsSelect.getSelectedId() - 1); };
+    addAndMakeVisible(mRenderThreadsSelect);
+
+    // Saves the pads' audio in the project, so it opens without the files.
+    mEmbedSamplesButton.onClick = [this] { mDataModel.setEmbedSamples(mEmbedSamplesButton.getToggleState()); };
+    addAndMakeVisible(mEmbedSamplesButton);
+
+    updateControls();
+}
+
+SettingsView::~SettingsView()
+{
+    mDataModel.removeListener(*this);
+}
+
+void SettingsView::paint(juce::Graphics& g)
+{
+    g.setColour(getLookAndFeel().findColour(AppColors::ColourIds::BackgroundDefault));
+    g.fillAll();
+
+    g.setColour(getLookAndFeel().findColour(AppColors::ColourIds::Divider));
+    auto bounds = getLocalBounds(); 
+    bounds.removeFromTop(spacing::padding3);
+    bounds.removeFromLeft(spacing::padding3);
+    bounds.removeFromRight(spacing::padding3);
+    g.fillRoundedRectangle(bounds.toFloat(), spacing::padding4); 
+}
+
+void SettingsView::resized()
+{
+    juce::Grid grid;
+
+    using Track = juce::Grid::TrackInfo;
+    using Fr = juce::Grid::Fr;
+
+    grid.templateRows = { Track(Fr(3)), Track(Fr(1)), Track(Fr(3)), Track(Fr(1)) };
+    grid.templateColumns = { Track(Fr(1)), Track(Fr(1)), Track(Fr(1)), Track(Fr(1)) };
+    grid.items = { juce::GridItem(mRenderThreadsSelect).withArea(1,1).withHeight(24).withAlignSelf(juce::GridItem::AlignSelf::center)
+                                                        .withMargin(juce::GridItem::Margin(0, spacing::padding3, 0, spacing::padding3)),
+                   juce::GridItem(mRenderThreadsLabel).withArea(2,1),
+                   juce::GridItem(mEmbedSamplesButton).withArea(1,2).withHeight(24).withAlignSelf(juce::GridItem::AlignSelf::center)
+                                                      .withMargin(juce::GridItem::Margin(0, spacing::padding3, 0, spacing::padding3))
+    };
+
+    grid.performLayout(getLocalBounds().reduced(spacing::padding3));
+}
+
+void SettingsView::settingChanged(const juce::Identifier&)
+{
+    updateControls();
+}
+
+void SettingsView::updateControls()
+{
+    mRenderThreadsSelect.setSelectedId(mDataModel.getRenderThreads() + 1, juce::dontSendNotification);
+    mEmbedSamplesButton.setToggleState(mDataModel.getEmbedSamples(), juce::dontSendNotification);
+}
+
+void SettingsView::lookAndFeelChanged()
+{
+    if (!dynamic_cast<juce::LookAndFeel_V4*>(&getLookAndFeel()))
+    {
+        mRenderThreadsLabel.setColour(juce::Label::textColourId, getLookAndFeel().findColour(AppColors::ColourIds::TextPrimary));
+        mEmbedSamplesButton.setColour(juce::ToggleButton::textColourId, getLookAndFeel().findColour(AppColors::ColourIds::TextPrimary));
+    }
+}
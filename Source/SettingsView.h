@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    SettingsView.h
+    Created: 18 Oct 2026 4:12:36am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "Model.h"
+#include "UIConfig.h"
+
+// Settings that apply to the whole instance rather than to one pad.
+class SettingsView : public juce::Component,
+    private DataModel::Listener
+{
+public:
+    SettingsView(const DataModel&);
+    ~SettingsView() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+    void lookAndFeelChanged() override;
+
+private:
+    // Data model listener
+    void settingChanged(const juce::Identifier&) override;
+
+    void updateControls();
+
+    juce::ComboBox mRenderThreadsSelect;
+    juce::Label mRenderThreadsLabel;
+    juce::ToggleButton mEmbedSamplesButton { "Embed Samples" };
+
+    DataModel mDataModel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SettingsView)
+};
@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    TripleBuffer.h
+    Created: 18 Oct 2026 2:10:44am
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//=====================================================================
+// Hands the latest value of a struct from one writer thread to one reader
+// thread without locks or allocation. The writer fills its own buffer and
+// publishes it by swapping it with a spare; the reader swaps the spare for
+// its own buffer when a new one is waiting. Neither side ever sees a
+// buffer the other is using, so a value is never torn, and the writer
+// never waits for the reader.
+//
+// The reader only ever sees the most recently published value; values
+// published in between are skipped.
+template <typename Type>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    // Writer only. The buffer to fill before publish().
+    Type& getWriteBuffer() noexcept { return buffers[(size_t)writeIndex]; }
+
+    // Writer only. Makes the write buffer the latest value.
+    void publish() noexcept
+    {
+        writeIndex = spare.exchange(writeIndex | newValueBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Reader only. The latest published value, which stays valid and
+    // unchanged until the next call.
+    const Type& read() noexcept
+    {
+        if ((spare.load(std::memory_order_relaxed) & newValueBit) != 0)
+            readIndex = spare.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+
+        return buffers[(size_t)readIndex];
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int newValueBit = 4;
+
+    std::array<Type, 3> buffers {};
+    int writeIndex = 0;
+    int readIndex = 1;
+    std::atomic<int> spare { 2 };
+
+    JUCE_DECLARE_NON_COPYABLE(TripleBuffer)
+};
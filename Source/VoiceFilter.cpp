@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+    VoiceFilter.cpp
+    Created: 17 Oct 2026 11:12:05pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "VoiceFilter.h"
+
+VoiceFilterBank::VoiceFilterBank()
+{
+}
+
+void VoiceFilterBank::prepare(double newSampleRate, int numContexts, int newNumChannels, int newMaxBlockSize)
+{
+    sampleRate = newSampleRate > 0 ? newSampleRate : 44100.0;
+    numChannels = juce::jlimit(1, maxChannels, newNumChannels);
+    maxBlockSize = juce::jmax(1, newMaxBlockSize);
+
+    contexts.clear();
+
+    for (int c = 0; c < numContexts; ++c)
+    {
+        auto context = std::make_unique<Context>();
+
+        for (auto& lane : context->lanes)
+            lane.setSize(numChannels, maxBlockSize);
+
+        context->interleavedData.calloc((size_t)maxBlockSize * numLanes + RenderKernels::alignment / sizeof(float));
+        context->interleaved = juce::snapPointerToAlignment(context->interleavedData.get(), RenderKernels::alignment);
+
+        contexts.push_back(std::move(context));
+    }
+
+    for (auto& channel : ic1eq)
+        channel.fill(0.0f);
+
+    for (auto& channel : ic2eq)
+        channel.fill(0.0f);
+}
+
+juce::AudioBuffer<float>& VoiceFilterBank::getLaneBuffer(int context, int lane) noexcept
+{
+    return contexts[(size_t)context]->lanes[(size_t)lane];
+}
+
+VoiceFilterBank::Coefficients VoiceFilterBank::makeCoefficients(float cutoff, float resonance) const noexcept
+{
+    const float nyquistLimit = (float)(sampleRate * 0.49);
+    const float frequency = juce::jlimit(10.0f, nyquistLimit, cutoff);
+
+    Coefficients c;
+    const float g = std::tan(juce::MathConstants<float>::pi * frequency / (float)sampleRate);
+    c.k = 1.0f / juce::jmax(0.1f, resonance);
+    c.a1 = 1.0f / (1.0f + g * (g + c.k));
+    c.a2 = g * c.a1;
+    c.a3 = g * c.a2;
+    return c;
+}
+
+void VoiceFilterBank::process(int contextIndex, const Lane* lanes, int numInUse,
+    juce::AudioBuffer<float>& target, int targetStart, int laneStart, int num) noexcept
+{
+    jassert(numInUse > 0 && numInUse <= numLanes && num <= maxBlockSize);
+
+    auto& context = *contexts[(size_t)contextIndex];
+    float* x = context.interleaved;
+
+    // Per-lane coefficients at the start of the block and their step per
+    // sample. Unused lanes filter silence with a zero output mix.
+    alignas(RenderKernels::alignment) float a1[numLanes] {}, a2[numLanes] {}, a3[numLanes] {}, k[numLanes] {};
+    alignas(RenderKernels::alignment) float da1[numLanes] {}, da2[numLanes] {}, da3[numLanes] {}, dk[numLanes] {};
+    alignas(RenderKernels::alignment) float mixLow[numLanes] {}, mixBand[numLanes] {}, mixHigh[numLanes] {};
+
+    const float step = 1.0f / (float)juce::jmax(1, num);
+
+    for (int l = 0; l < numInUse; ++l)
+    {
+        const auto& lane = lanes[l];
+        const auto end = makeCoefficients(lane.cutoff, lane.resonance);
+        auto& last = lastCoefficients[(size_t)lane.slot];
+
+        if (lane.reset)
+        {
+            last = end;
+
+            for (int ch = 0; ch < maxChannels; ++ch)
+                ic1eq[(size_t)ch][(size_t)lane.slot] = ic2eq[(size_t)ch][(size_t)lane.slot] = 0.0f;
+        }
+
+        da1[l] = (end.a1 - last.a1) * step;
+        da2[l] = (end.a2 - last.a2) * step;
+        da3[l] = (end.a3 - last.a3) * step;
+        dk[l] = (end.k - last.k) * step;
+
+        a1[l] = last.a1;
+        a2[l] = last.a2;
+        a3[l] = last.a3;
+        k[l] = last.k;
+
+        mixLow[l] = lane.mode == FilterMode::lowpass ? 1.0f : 0.0f;
+        mixBand[l] = lane.mode == FilterMode::bandpass ? 1.0f : 0.0f;
+        mixHigh[l] = lane.mode == FilterMode::highpass ? 1.0f : 0.0f;
+
+        last = end;
+    }
+
+    for (int l = numInUse; l < numLanes; ++l)
+        a1[l] = 1.0f;
+
+    const int channelsToProcess = juce::jmin(numChannels, target.getNumChannels());
+
+    for (int ch = 0; ch < channelsToProcess; ++ch)
+    {
+        alignas(RenderKernels::alignment) float s1[numLanes] {}, s2[numLanes] {};
+
+        for (int l = 0; l < numInUse; ++l)
+        {
+            s1[l] = ic1eq[(size_t)ch][(size_t)lanes[l].slot];
+            s2[l] = ic2eq[(size_t)ch][(size_t)lanes[l].slot];
+        }
+
+        // Voice-major to sample-major, so each sample of every lane is one
+        // register load.
+        for (int l = 0; l < numLanes; ++l)
+        {
+            if (l < numInUse)
+            {
+                const float* src = context.lanes[(size_t)l].getReadPointer(ch, laneStart);
+
+                for (int i = 0; i < num; ++i)
+                    x[i * numLanes + l] = src[i];
+            }
+            else
+            {
+                for (int i = 0; i < num; ++i)
+                    x[i * numLanes + l] = 0.0f;
+            }
+        }
+
+        // The ramps restart for each channel, from the block's start values.
+        alignas(RenderKernels::alignment) float c1[numLanes], c2[numLanes], c3[numLanes], ck[numLanes];
+        std::copy(a1, a1 + numLanes, c1);
+        std::copy(a2, a2 + numLanes, c2);
+        std::copy(a3, a3 + numLanes, c3);
+        std::copy(k, k + numLanes, ck);
+
+       #if JUCE_USE_SIMD
+        using Vec = RenderKernels::FloatVec;
+
+        auto vs1 = Vec::fromRawArray(s1), vs2 = Vec::fromRawArray(s2);
+        auto va1 = Vec::fromRawArray(c1), va2 = Vec::fromRawArray(c2), va3 = Vec::fromRawArray(c3), vk = Vec::fromRawArray(ck);
+        const auto vd1 = Vec::fromRawArray(da1), vd2 = Vec::fromRawArray(da2), vd3 = Vec::fromRawArray(da3), vdk = Vec::fromRawArray(dk);
+        const auto vLow = Vec::fromRawArray(mixLow), vBand = Vec::fromRawArray(mixBand), vHigh = Vec::fromRawArray(mixHigh);
+        const auto two = Vec::expand(2.0f);
+
+        for (int i = 0; i < num; ++i)
+        {
+            va1 += vd1;
+            va2 += vd2;
+            va3 += vd3;
+            vk += vdk;
+
+            float* frame = x + i * numLanes;
+            const auto v0 = Vec::fromRawArray(frame);
+            const auto v3 = v0 - vs2;
+            const auto v1 = va1 * vs1 + va2 * v3;
+            const auto v2 = vs2 + va2 * vs1 + va3 * v3;
+
+            vs1 = two * v1 - vs1;
+            vs2 = two * v2 - vs2;
+
+            (vLow * v2 + vBand * v1 + vHigh * (v0 - vk * v1 - v2)).copyToRawArray(frame);
+        }
+
+        vs1.copyToRawArray(s1);
+        vs2.copyToRawArray(s2);
+       #else
+        for (int i = 0; i < num; ++i)
+        {
+            float* frame = x + i * numLanes;
+
+            for (int l = 0; l < numLanes; ++l)
+            {
+                c1[l] += da1[l];
+                c2[l] += da2[l];
+                c3[l] += da3[l];
+                ck[l] += dk[l];
+
+                const float v0 = frame[l];
+                const float v3 = v0 - s2[l];
+                const float v1 = c1[l] * s1[l] + c2[l] * v3;
+                const float v2 = s2[l] + c2[l] * s1[l] + c3[l] * v3;
+
+                s1[l] = 2.0f * v1 - s1[l];
+                s2[l] = 2.0f * v2 - s2[l];
+
+                frame[l] = mixLow[l] * v2 + mixBand[l] * v1 + mixHigh[l] * (v0 - ck[l] * v1 - v2);
+            }
+        }
+       #endif
+
+        for (int l = 0; l < numInUse; ++l)
+        {
+            ic1eq[(size_t)ch][(size_t)lanes[l].slot] = s1[l];
+            ic2eq[(size_t)ch][(size_t)lanes[l].slot] = s2[l];
+        }
+
+        float* dest = target.getWritePointer(ch, targetStart);
+
+        for (int l = 0; l < numInUse; ++l)
+            for (int i = 0; i < num; ++i)
+                dest[i] += x[i * numLanes + l];
+    }
+}
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    VoiceFilter.h
+    Created: 17 Oct 2026 11:12:05pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include <vector>
+#include "Model.h"
+#include "RenderKernels.h"
+
+//=====================================================================
+// Topology-preserving-transform state-variable filters for up to maxSlots
+// voices, run numLanes voices at a time: each SIMD lane is one voice, so a
+// group of voices costs about as much as one. The filter state is kept as
+// structure-of-arrays indexed by voice slot and loaded into registers once
+// per group rather than per sample.
+//
+// Coefficients are worked out once per block from each voice's cutoff and
+// ramped linearly from the previous block's values, so cutoff changes
+// driven by the envelope are smooth without a tan() per sample. The mode
+// is applied as a per-lane mix of the low, band and high outputs, so lanes
+// with different modes share the same instructions.
+class VoiceFilterBank
+{
+public:
+    static constexpr int numLanes = RenderKernels::vecSize;
+    static constexpr int maxSlots = 256;
+    static constexpr int maxChannels = 2;
+
+    // One voice of a group.
+    struct Lane
+    {
+        int slot = 0;               // Which voice's state to use
+        bool reset = false;         // The voice has started a new note
+        FilterMode mode = FilterMode::lowpass;
+        float cutoff = 20000.0f;    // Hz, at the end of the block
+        float resonance = 0.7071f;
+    };
+
+    VoiceFilterBank();
+
+    // Not while rendering. numContexts is the number of threads that may
+    // call process() at once, each with its own scratch.
+    void prepare(double sampleRate, int numContexts, int numChannels, int maxBlockSize);
+
+    bool isPrepared() const noexcept { return !contexts.empty(); }
+    int getMaxBlockSize() const noexcept { return maxBlockSize; }
+
+    // Scratch for a group's voices to render into before they are filtered.
+    // Sized numChannels by maxBlockSize.
+    juce::AudioBuffer<float>& getLaneBuffer(int context, int lane) noexcept;
+
+    // Filters frames [laneStart, laneStart + num) of the first numInUse lane
+    // buffers of context and adds them to target from targetStart.
+    void process(int context, const Lane* lanes, int numInUse,
+        juce::AudioBuffer<float>& target, int targetStart, int laneStart, int num) noexcept;
+
+private:
+    struct Coefficients
+    {
+        float a1 = 1.0f, a2 = 0.0f, a3 = 0.0f, k = 1.0f;
+    };
+
+    struct Context
+    {
+        std::array<juce::AudioBuffer<float>, numLanes> lanes;
+        juce::HeapBlock<float> interleavedData;
+        float* interleaved = nullptr;    // maxBlockSize frames of numLanes, aligned
+    };
+
+    Coefficients makeCoefficients(float cutoff, float resonance) const noexcept;
+
+    // Filter state per channel and slot, structure-of-arrays.
+    std::array<std::array<float, maxSlots>, maxChannels> ic1eq {}, ic2eq {};
+    std::array<Coefficients, maxSlots> lastCoefficients {};
+
+    std::vector<std::unique_ptr<Context>> contexts;
+    double sampleRate = 44100.0;
+    int numChannels = 0, maxBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoiceFilterBank)
+};
@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+
+    VoiceRenderPool.cpp
+    Created: 17 Oct 2026 9:52:40pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#include "VoiceRenderPool.h"
+
+//================================================================================
+class VoiceRenderPool::Worker : public juce::Thread
+{
+public:
+    Worker(VoiceRenderPool& ownerPool, int workerIndex)
+        : juce::Thread("Voice render " + juce::String(workerIndex + 1)),
+        owner(ownerPool),
+        index(workerIndex)
+    {
+    }
+
+    ~Worker() override
+    {
+        stopThread(2000);
+    }
+
+    void run() override
+    {
+        // Denormal handling is per thread; match the host's audio thread.
+        juce::ScopedNoDenormals noDenormals;
+
+        juce::uint32 seen = 0;
+
+        while (!threadShouldExit())
+        {
+            const auto current = getGeneration(owner.state.load(std::memory_order_acquire));
+
+            if (current != seen)
+            {
+                seen = current;
+
+                // The job is only stable once joined, so whether this worker
+                // is wanted is checked inside.
+                if (owner.tryJoin(current))
+                {
+                    if (isWanted())
+                        owner.renderVoices(scratchView, this);
+
+                    owner.leave();
+                }
+
+                continue;
+            }
+
+            // The audio thread checks isSleeping after publishing a job, so
+            // either it sees the flag and wakes us, or we see the new job.
+            isSleeping.store(true);
+
+            if (getGeneration(owner.state.load()) == seen)
+                wait(-1);
+
+            isSleeping.store(false);
+        }
+    }
+
+    void prepare(int numChannels, int maxBlockSize)
+    {
+        scratch.setSize(numChannels, maxBlockSize);
+        scratch.clear();
+    }
+
+    bool isWanted() const noexcept { return index < owner.job.numWorkers; }
+
+    // Set up before a job is published; refers to scratch with the size of
+    // the block being rendered, so voices see the same buffer geometry.
+    void setView(int numChannels, int numSamples) noexcept
+    {
+        scratchView.setDataToReferTo(scratch.getArrayOfWritePointers(), numChannels, numSamples);
+        hasOutput.store(false, std::memory_order_relaxed);
+    }
+
+    int getContext() const noexcept { return index + 1; }
+
+    std::atomic<bool> isSleeping { false };
+    std::atomic<bool> hasOutput { false };
+    juce::AudioBuffer<float> scratch, scratchView;
+
+private:
+    VoiceRenderPool& owner;
+    const int index;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+};
+
+//================================================================================
+VoiceRenderPool::VoiceRenderPool()
+{
+}
+
+VoiceRenderPool::~VoiceRenderPool()
+{
+    workers.clear();
+}
+
+void VoiceRenderPool::acquire() noexcept
+{
+    while (isBusy.exchange(true, std::memory_order_acquire))
+        juce::Thread::sleep(1);
+}
+
+void VoiceRenderPool::reserveThreads(int numThreads)
+{
+    const int target = juce::jlimit(0, maxThreads, numThreads);
+
+    if ((int)workers.size() >= target)
+        return;
+
+    acquire();
+
+    while ((int)workers.size() < target)
+    {
+        workers.push_back(std::make_unique<Worker>(*this, (int)workers.size()));
+        workers.back()->prepare(scratchChannels, scratchSize);
+        workers.back()->startRealtimeThread(juce::Thread::RealtimeOptions {});
+    }
+
+    release();
+}
+
+void VoiceRenderPool::prepare(int numChannels, int maxBlockSize)
+{
+    acquire();
+
+    // Instances may differ, so the scratch fits the largest.
+    scratchChannels = juce::jmax(scratchChannels, numChannels);
+    scratchSize = juce::jmax(scratchSize, maxBlockSize);
+
+    for (auto& worker : workers)
+        if (worker->scratch.getNumChannels() < scratchChannels || worker->scratch.getNumSamples() < scratchSize)
+            worker->prepare(scratchChannels, scratchSize);
+
+    release();
+}
+
+bool VoiceRenderPool::render(Renderer& renderer, int maxWorkers, int numItems, int numVoices,
+    juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    if (maxWorkers <= 0 || numItems < 2)
+        return false;
+
+    if (isBusy.exchange(true, std::memory_order_acquire))
+        return false;
+
+    const int numWorkers = juce::jmin(maxWorkers, (int)workers.size());
+
+    if (numWorkers == 0 || numVoices < (numWorkers + 1) * minVoicesPerThread
+        || buffer.getNumSamples() > scratchSize || buffer.getNumChannels() > scratchChannels)
+    {
+        release();
+        return false;
+    }
+
+    job.renderer = &renderer;
+    job.numWorkers = numWorkers;
+    job.numItems = numItems;
+    job.startSample = startSample;
+    job.numSamples = numSamples;
+    job.bufferSize = buffer.getNumSamples();
+    job.numChannels = buffer.getNumChannels();
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers[(size_t)i]->setView(job.numChannels, job.bufferSize);
+
+    nextItem.store(0, std::memory_order_relaxed);
+
+    // Publishes the job and opens it in one store.
+    state.store(juce::uint64(++generation) << 32);
+
+    for (int i = 0; i < numWorkers; ++i)
+        if (workers[(size_t)i]->isSleeping.load())
+            workers[(size_t)i]->notify();
+
+    renderVoices(buffer, nullptr);
+
+    // Late workers can no longer join; wait for those inside to finish their
+    // current item.
+    state.fetch_or(closedFlag, std::memory_order_acq_rel);
+
+    while ((state.load(std::memory_order_acquire) & countMask) != 0)
+        juce::Thread::yield();
+
+    // hasOutput was published by each worker's release when it left.
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto& worker = workers[(size_t)i];
+
+        if (!worker->hasOutput.load(std::memory_order_relaxed))
+            continue;
+
+        for (int ch = 0; ch < job.numChannels; ++ch)
+            buffer.addFrom(ch, startSample, worker->scratch, ch, startSample, numSamples);
+    }
+
+    release();
+    return true;
+}
+
+bool VoiceRenderPool::tryJoin(juce::uint32 jobGeneration) noexcept
+{
+    auto current = state.load(std::memory_order_acquire);
+
+    while (getGeneration(current) == jobGeneration && (current & closedFlag) == 0)
+    {
+        if (state.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            return true;
+    }
+
+    return false;
+}
+
+void VoiceRenderPool::leave() noexcept
+{
+    state.fetch_sub(1, std::memory_order_release);
+}
+
+void VoiceRenderPool::renderVoices(juce::AudioBuffer<float>& target, Worker* worker) noexcept
+{
+    for (int i = nextItem.fetch_add(1, std::memory_order_relaxed); i < job.numItems;
+         i = nextItem.fetch_add(1, std::memory_order_relaxed))
+    {
+        // A worker's scratch still holds its last job, so it is cleared
+        // once the worker knows it has something to add.
+        if (worker != nullptr && !worker->hasOutput.load(std::memory_order_relaxed))
+        {
+            for (int ch = 0; ch < job.numChannels; ++ch)
+                target.clear(ch, job.startSample, job.numSamples);
+
+            worker->hasOutput.store(true, std::memory_order_relaxed);
+        }
+
+        job.renderer->renderItem(i, worker != nullptr ? worker->getContext() : 0, target, job.startSample, job.numSamples);
+    }
+}
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    VoiceRenderPool.h
+    Created: 17 Oct 2026 9:52:40pm
+    Author:  camro
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//=====================================================================
+// Renders a block's voices on several cores. The audio thread publishes a
+// job, then takes part in it: it and every worker that joins in time pull
+// items (single voices, or groups of voices filtered together) from a
+// shared counter, so a slow or late worker never holds up more than the
+// item it is already rendering. Workers render into their
+// own scratch buffers, which the audio thread adds to the output once the
+// last one has left.
+//
+// One pool is shared by every instance in the process through
+// juce::SharedResourcePointer, so several instances never run more workers
+// than one would. It runs one job at a time; an instance that finds it
+// busy renders its block serially. Workers sleep between jobs, are left
+// to the scheduler rather than pinned to cores, and run as real-time
+// threads like the host's own audio threads.
+//
+// Job state lives in one atomic word (generation, closed flag and number
+// of workers inside), so joining, leaving and closing are single atomic
+// operations and the audio thread never takes a lock except to wake a
+// sleeping worker.
+class VoiceRenderPool
+{
+public:
+    static constexpr int maxThreads = 8;
+
+    // Below this many voices per thread (the audio thread included), the
+    // hand-off costs more than it saves and voices are rendered serially.
+    static constexpr int minVoicesPerThread = 4;
+
+    // Renders one item of a job. context identifies the calling thread: 0
+    // for the audio thread, 1.. for the workers, so per-thread scratch can
+    // be indexed without locking.
+    class Renderer
+    {
+    public:
+        virtual ~Renderer() = default;
+        virtual void renderItem(int item, int context, juce::AudioBuffer<float>& target,
+            int startSample, int numSamples) noexcept = 0;
+    };
+
+    VoiceRenderPool();
+    ~VoiceRenderPool();
+
+    // Start at least this many workers, and make the scratch buffers at
+    // least this big. Both wait for any job in progress, so they must not
+    // be called from an audio thread (e.g. call from prepareToPlay).
+    void reserveThreads(int numThreads);
+    void prepare(int numChannels, int maxBlockSize);
+
+    // Audio thread. Renders items [0, numItems) into buffer with the help of
+    // up to maxWorkers workers, whose contexts are 1..maxWorkers, and
+    // returns true. Returns false without rendering anything if numVoices is
+    // too few to benefit, the block does not fit the scratch buffers, or
+    // another instance is using the pool.
+    bool render(Renderer&, int maxWorkers, int numItems, int numVoices,
+        juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+private:
+    class Worker;
+
+    struct Job
+    {
+        Renderer* renderer = nullptr;
+        int numWorkers = 0;    // Workers with a higher index stay out
+        int numItems = 0;
+        int startSample = 0;
+        int numSamples = 0;
+        int bufferSize = 0;
+        int numChannels = 0;
+    };
+
+    // state: generation in the upper 32 bits, closedFlag, and the number of
+    // workers inside the job in the remaining bits.
+    static constexpr juce::uint64 closedFlag = juce::uint64(1) << 31;
+    static constexpr juce::uint64 countMask = closedFlag - 1;
+
+    static juce::uint32 getGeneration(juce::uint64 state) noexcept { return static_cast<juce::uint32>(state >> 32); }
+
+    // Waits until no job is running and keeps others from starting one.
+    void acquire() noexcept;
+    void release() noexcept { isBusy.store(false, std::memory_order_release); }
+
+    bool tryJoin(juce::uint32 generation) noexcept;
+    void leave() noexcept;
+    // worker is nullptr on the audio thread, which renders into the output.
+    void renderVoices(juce::AudioBuffer<float>& target, Worker* worker) noexcept;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    int scratchChannels = 0, scratchSize = 0;
+
+    // Written by the audio thread before the job's generation is published.
+    Job job;
+    juce::uint32 generation = 0;
+
+    std::atomic<juce::uint64> state { closedFlag };
+    std::atomic<int> nextItem { 0 };
+
+    // Held by the instance running a job, or by reserveThreads and prepare.
+    std::atomic<bool> isBusy { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoiceRenderPool)
+};